@@ -0,0 +1,116 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "icosphere.hpp"
+
+/**
+ * Type-erased icosphere mesh, whose index type is the smallest one (among \p std::uint16_t, \p std::uint32_t and
+ * \p std::uint64_t) that can represent all position indices of the subdivision level. The level is given at runtime,
+ * and the generation is dispatched to the corresponding \p Icosphere instantiation.
+ *
+ * @code
+ * const AnyMesh mesh = AnyMesh::generate(level); // Mesh<std::uint16_t> for level <= 6.
+ * mesh.visit([](const auto &mesh){
+ *     // mesh is Mesh<std::uint16_t>, Mesh<std::uint32_t> or Mesh<std::uint64_t>.
+ * });
+ * @endcode
+ */
+class AnyMesh{
+public:
+    using variant_t = std::variant<Mesh<std::uint16_t>, Mesh<std::uint32_t>, Mesh<std::uint64_t>>;
+
+private:
+    variant_t mesh;
+
+    template <std::size_t I = 0>
+    static variant_t generateImpl(std::uint8_t level){
+        if constexpr (I == std::variant_size_v<variant_t>){
+            throw std::overflow_error { "Icosphere of level " + std::to_string(level) + " is too large to be indexed." };
+        }
+        else{
+            using index_t = typename std::variant_alternative_t<I, variant_t>::triangle_index_t::value_type;
+            if (Icosphere<index_t>::isRepresentable(level)){
+                return Icosphere<index_t>::generate(level);
+            }
+            return generateImpl<I + 1>(level);
+        }
+    }
+
+    template <std::size_t I = 0>
+    static constexpr std::size_t indexSizeImpl(std::uint8_t level){
+        if constexpr (I == std::variant_size_v<variant_t>){
+            throw std::overflow_error { "Icosphere of level " + std::to_string(level) + " is too large to be indexed." };
+        }
+        else{
+            using index_t = typename std::variant_alternative_t<I, variant_t>::triangle_index_t::value_type;
+            return Icosphere<index_t>::isRepresentable(level) ? sizeof(index_t) : indexSizeImpl<I + 1>(level);
+        }
+    }
+
+public:
+    explicit AnyMesh(variant_t mesh) noexcept : mesh { std::move(mesh) } { }
+
+    /**
+     * Generate the icosphere mesh with the smallest index type for the given subdivision level.
+     * @param level Subdivision level.
+     * @return Generated mesh.
+     * @throw std::overflow_error If no index type can represent the position indices (level > 30).
+     */
+    static AnyMesh generate(std::uint8_t level){
+        return AnyMesh { generateImpl(level) };
+    }
+
+    /**
+     * @brief Get the size (in bytes) of the index type which \p generate() would choose for the given subdivision level.
+     * @throw std::overflow_error If no index type can represent the position indices (level > 30).
+     */
+    static constexpr std::size_t indexSize(std::uint8_t level){
+        return indexSizeImpl(level);
+    }
+
+    /**
+     * @brief Get the number of bytes of the triangle indices saved by the chosen index type, compared to
+     * \p std::uint32_t indices. It is negative if the chosen index type is larger than 32-bit.
+     */
+    static constexpr std::int64_t indexBytesSaved(std::uint8_t level){
+        // indexSize() throws for the levels whose triangle count cannot be computed, so it must be called first.
+        const auto index_size = static_cast<std::int64_t>(indexSize(level));
+        return static_cast<std::int64_t>(3 * Icosphere<std::uint64_t>::numTriangles(level))
+             * (static_cast<std::int64_t>(sizeof(std::uint32_t)) - index_size);
+    }
+
+    template <typename Visitor>
+    decltype(auto) visit(Visitor &&visitor) const{
+        return std::visit(std::forward<Visitor>(visitor), mesh);
+    }
+
+    [[nodiscard]] const std::vector<glm::vec3> &positions() const noexcept{
+        return visit([](const auto &mesh) -> const std::vector<glm::vec3>& { return mesh.positions; });
+    }
+
+    [[nodiscard]] std::size_t numTriangles() const noexcept{
+        return visit([](const auto &mesh){ return mesh.triangle_indices.size(); });
+    }
+
+    [[nodiscard]] std::size_t indexSize() const noexcept{
+        return visit([]<typename IndexType>(const Mesh<IndexType>&){ return sizeof(IndexType); });
+    }
+
+    [[nodiscard]] const void *indexData() const noexcept{
+        return visit([](const auto &mesh) -> const void* { return mesh.triangle_indices.data(); });
+    }
+
+    [[nodiscard]] std::size_t indexBytes() const noexcept{
+        return 3 * numTriangles() * indexSize();
+    }
+};
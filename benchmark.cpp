@@ -0,0 +1,897 @@
+#include <bit>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <tuple>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <measure_execution.hpp>
+
+#include "any_mesh.hpp"
+#include "bvh.hpp"
+#include "decimation.hpp"
+#include "icosphere.hpp"
+#include "instancing.hpp"
+#include "laplacian.hpp"
+#include "mesh_export.hpp"
+#include "software_rasterizer.hpp"
+
+#ifndef ICOSPHERE_GOLDEN_DIR
+#define ICOSPHERE_GOLDEN_DIR "golden" // Directory of the golden images, set by CMake.
+#endif
+
+namespace {
+    // Run the function repeatedly (at least min_runs times and at least min_duration long), and return the average
+    // elapsed time of a single run.
+    template <std::invocable Fn>
+    std::chrono::duration<double, std::milli> measure_average(Fn &&func,
+                                                              int min_runs = 5,
+                                                              std::chrono::duration<double, std::milli> min_duration = std::chrono::milliseconds { 200 })
+    {
+        int runs = 0;
+        std::chrono::duration<double, std::milli> total { 0 };
+        while (runs < min_runs || total < min_duration){
+            total += measure_execution<double>(func);
+            ++runs;
+        }
+        return total / runs;
+    }
+
+    // Single thread, and all hardware threads if there are more than one.
+    std::vector<unsigned> thread_counts(){
+        if (const unsigned num_threads = default_thread_count(); num_threads > 1){
+            return { 1U, num_threads };
+        }
+        return { 1U };
+    }
+
+    // Read the whole file as bytes.
+    std::string read_file(const std::filesystem::path &path){
+        std::ifstream file { path, std::ios::binary };
+        return { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+    }
+
+    // Parse an exported mesh back, and return the number of positions and triangles that differ from the mesh. Positions
+    // are compared bitwise, as the text formats use the shortest round-trip representation. A malformed file counts as
+    // all of them differing.
+    template <typename IndexType>
+    std::size_t count_readback_mismatches(std::string_view bytes, MeshFormat format, const Mesh<IndexType> &mesh){
+        const std::size_t num_elements = mesh.positions.size() + mesh.triangle_indices.size();
+        std::size_t offset = 0;
+        const auto skip_spaces = [&]{
+            while (offset < bytes.size() && (bytes[offset] == ' ' || bytes[offset] == '\n')) ++offset;
+        };
+        const auto expect = [&](std::string_view token){
+            skip_spaces();
+            if (!bytes.substr(offset).starts_with(token)) return false;
+            offset += token.size();
+            return true;
+        };
+        const auto parse = [&]<typename T>(T &value){
+            skip_spaces();
+            const auto [ptr, ec] = std::from_chars(bytes.data() + offset, bytes.data() + bytes.size(), value);
+            offset = static_cast<std::size_t>(ptr - bytes.data());
+            return ec == std::errc {};
+        };
+        const auto read_binary = [&]<typename T>(T &value){
+            if (bytes.size() - offset < sizeof(T)) return false;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        };
+
+        // Header.
+        std::size_t num_vertices, num_triangles;
+        std::size_t index_size = 0; // Binary PLY only.
+        if (format == MeshFormat::Obj){
+            if (!expect("#") || !parse(num_vertices) || !expect("vertices,") || !parse(num_triangles) || !expect("triangles")){
+                return num_elements;
+            }
+        }
+        else{
+            const std::size_t header_end = bytes.find("end_header\n");
+            if (!bytes.starts_with("ply\n") || header_end == std::string_view::npos){
+                return num_elements;
+            }
+            const std::string_view header = bytes.substr(0, header_end);
+            if ((offset = header.find("element vertex ")) == std::string_view::npos || !expect("element vertex ") || !parse(num_vertices)
+                || (offset = header.find("element face ")) == std::string_view::npos || !expect("element face ") || !parse(num_triangles)){
+                return num_elements;
+            }
+            index_size = header.find("uchar ushort") != std::string_view::npos ? 2 : 4;
+            offset = header_end + std::string_view { "end_header\n" }.size();
+        }
+        if (num_vertices != mesh.positions.size() || num_triangles != mesh.triangle_indices.size()){
+            return num_elements;
+        }
+
+        std::size_t num_mismatches = 0;
+        for (const glm::vec3 &position : mesh.positions){
+            glm::vec3 read_position;
+            if (format == MeshFormat::PlyBinary
+                    ? !read_binary(read_position.x) || !read_binary(read_position.y) || !read_binary(read_position.z)
+                    : (format == MeshFormat::Obj && !expect("v ")) || !parse(read_position.x) || !parse(read_position.y) || !parse(read_position.z)){
+                return num_elements;
+            }
+            num_mismatches += read_position != position;
+        }
+        for (const auto &indices : mesh.triangle_indices){
+            std::array<std::uint64_t, 3> read_indices;
+            if (format == MeshFormat::PlyBinary){
+                std::uint8_t count;
+                if (!read_binary(count) || count != 3) return num_elements;
+                for (std::uint64_t &index : read_indices){
+                    std::uint16_t index16;
+                    std::uint32_t index32;
+                    if (index_size == 2 ? !read_binary(index16) : !read_binary(index32)) return num_elements;
+                    index = index_size == 2 ? index16 : index32;
+                }
+            }
+            else{
+                if (!expect(format == MeshFormat::Obj ? "f " : "3 ")) return num_elements;
+                for (std::uint64_t &index : read_indices){
+                    if (!parse(index)) return num_elements;
+                    index -= format == MeshFormat::Obj; // OBJ indices are 1-based.
+                }
+            }
+            num_mismatches += !std::ranges::equal(read_indices, indices);
+        }
+
+        // Nothing may follow the triangles.
+        skip_spaces();
+        return offset == bytes.size() ? num_mismatches : num_elements;
+    }
+
+    bool benchmarkLaplacian(){
+        using index_t = std::uint32_t;
+
+        std::printf("%5s %10s %12s %10s %12s %12s %10s %10s\n",
+                    "level", "vertices", "nonzeros", "adj(ms)", "uniform(ms)", "cotan(ms)", "GFLOP/s", "GB/s");
+        for (std::uint8_t level = 6; level <= 10; ++level){
+            const auto mesh = Icosphere<index_t>::generate(level);
+
+            const auto [adjacency, adjacency_elapsed] = measure_execution_with_result([&]{
+                return Icosphere<index_t>::generateAdjacency(mesh);
+            });
+            const auto [uniform, uniform_elapsed] = measure_execution_with_result([&]{
+                return Laplacian::uniform(adjacency);
+            });
+            const auto [cotangent, cotangent_elapsed] = measure_execution_with_result([&]{
+                return Laplacian::cotangent<index_t>(adjacency, mesh.positions);
+            });
+
+            std::vector<float> x(mesh.positions.size()), y(mesh.positions.size());
+            std::iota(x.begin(), x.end(), 0.f);
+            const auto spmv_elapsed = measure_average([&]{ spmv(cotangent, x, y); });
+
+            /*
+             * Each nonzero needs one multiply and one add. Memory traffic counts the matrix (values, column indices and
+             * row offsets), one read of x per nonzero (gather, assuming no cache reuse) and one write of y per row.
+             */
+            const double flops = 2.0 * static_cast<double>(cotangent.numNonZeros());
+            const double bytes = static_cast<double>(cotangent.numNonZeros() * (sizeof(float) + sizeof(index_t) + sizeof(float))
+                                                     + cotangent.numRows() * (sizeof(std::size_t) + sizeof(float)));
+            const double seconds = std::chrono::duration<double>(spmv_elapsed).count();
+
+            std::printf("%5d %10zu %12zu %10.3f %12.3f %12.3f %10.3f %10.3f\n",
+                        level, mesh.positions.size(), cotangent.numNonZeros(),
+                        adjacency_elapsed.count(), uniform_elapsed.count(), cotangent_elapsed.count(),
+                        flops / seconds * 1e-9, bytes / seconds * 1e-9);
+        }
+
+        /*
+         * Small index types: the number of nonzeros exceeds 65535 from level 5 (uniform/cotangent) and level 6
+         * (adjacency), while the vertex indices still fit. The result must be the same as the 32-bit one.
+         */
+        bool passed = true;
+        std::printf("%5s %10s %12s %12s\n", "level", "index type", "nonzeros", "mismatches");
+        for (std::uint8_t level : { 5, 6 }){
+            const auto mesh16 = Icosphere<std::uint16_t>::generate(level);
+            const auto mesh32 = Icosphere<std::uint32_t>::generate(level);
+            const auto adjacency16 = Icosphere<std::uint16_t>::generateAdjacency(mesh16);
+            const auto adjacency32 = Icosphere<std::uint32_t>::generateAdjacency(mesh32);
+            const auto uniform16 = Laplacian::uniform(adjacency16);
+            const auto uniform32 = Laplacian::uniform(adjacency32);
+            const auto cotangent16 = Laplacian::cotangent<std::uint16_t>(adjacency16, mesh16.positions);
+            const auto cotangent32 = Laplacian::cotangent<std::uint32_t>(adjacency32, mesh32.positions);
+
+            std::size_t num_mismatches = 0;
+            const auto count_mismatches = [&](const auto &values16, const auto &values32){
+                if (values16.size() != values32.size()){
+                    num_mismatches += std::max(values16.size(), values32.size());
+                    return;
+                }
+                for (std::size_t i = 0; i < values16.size(); ++i){
+                    num_mismatches += values16[i] != values32[i];
+                }
+            };
+            count_mismatches(adjacency16.row_offsets, adjacency32.row_offsets);
+            count_mismatches(adjacency16.neighbor_indices, adjacency32.neighbor_indices);
+            for (const auto &[matrix16, matrix32] : { std::pair { &uniform16, &uniform32 }, std::pair { &cotangent16, &cotangent32 } }){
+                count_mismatches(matrix16->row_offsets, matrix32->row_offsets);
+                count_mismatches(matrix16->column_indices, matrix32->column_indices);
+                count_mismatches(matrix16->values, matrix32->values);
+            }
+
+            std::printf("%5d %7zu-bit %12zu %12zu\n", level, 8 * sizeof(std::uint16_t), cotangent16.numNonZeros(), num_mismatches);
+            passed &= num_mismatches == 0;
+        }
+        return passed;
+    }
+
+    bool benchmarkInstancing(){
+        const glm::mat4 projection_view = glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 1000.f)
+                                        * glm::lookAt(glm::vec3 { 0.f, 0.f, 50.f }, glm::vec3 { 0.f }, glm::vec3 { 0.f, 1.f, 0.f });
+
+        std::printf("%10s %8s %10s %8s %12s %16s\n",
+                    "instances", "threads", "visible", "batches", "time(ms)", "instances/ms");
+        for (std::size_t num_instances : { 100'000, 1'000'000, 4'000'000 }){
+            std::mt19937 random_engine { 0 };
+            std::uniform_real_distribution<float> center_distribution { -100.f, 100.f }, radius_distribution { 0.2f, 0.6f };
+            std::vector<SphereInstance> instances(num_instances);
+            std::ranges::generate(instances, [&]{
+                const glm::vec3 center { center_distribution(random_engine), center_distribution(random_engine), center_distribution(random_engine) };
+                return SphereInstance { center, radius_distribution(random_engine) };
+            });
+
+            for (unsigned num_threads : thread_counts()){
+                InstanceCuller culler { .max_level = 5, .num_threads = num_threads, .instances = {}, .batches = {} };
+                const auto elapsed = measure_average([&]{
+                    culler.cull(instances, projection_view, glm::vec3 { 0.f, 0.f, 50.f });
+                });
+
+                std::printf("%10zu %8u %10zu %8zu %12.3f %16.1f\n",
+                            num_instances, num_threads, culler.instances.size(), culler.batches.size(),
+                            elapsed.count(), static_cast<double>(num_instances) / elapsed.count());
+            }
+        }
+        return true;
+    }
+
+    bool benchmarkIndexType(){
+        std::printf("%5s %10s %12s %14s %14s %12s %12s\n",
+                    "level", "index type", "triangles", "index bytes", "bytes saved", "any(ms)", "uint32(ms)");
+        for (std::uint8_t level = 0; level <= 10; ++level){
+            const auto [mesh, elapsed] = measure_execution_with_result([&]{ return AnyMesh::generate(level); });
+            const auto uint32_elapsed = measure_execution([&]{ return Icosphere<std::uint32_t>::generate(level); });
+
+            std::printf("%5d %7zu-bit %12zu %14zu %14lld %12.3f %12.3f\n",
+                        level, 8 * mesh.indexSize(), mesh.numTriangles(), mesh.indexBytes(),
+                        static_cast<long long>(AnyMesh::indexBytesSaved(level)), elapsed.count(), uint32_elapsed.count());
+        }
+        return true;
+    }
+
+    bool benchmarkRasterizer(){
+        constexpr int width = 1920, height = 1080;
+        constexpr int golden_size = 256; // Golden images are golden_size x golden_size, of level 2.
+        constexpr std::uint8_t golden_channel_tolerance = 2; // Absorbs float rounding differences between glm versions and compilers.
+        constexpr unsigned min_checked_threads = 4; // Thread count whose output is always checked, even on a single core.
+        constexpr glm::vec3 view_pos { 0.f, 0.f, 3.f };
+        const auto make_mvp_matrix = [&](int width, int height){
+            return MvpMatrixUniform {
+                glm::identity<glm::mat4>(),
+                glm::identity<glm::mat4>(),
+                glm::perspective(glm::radians(45.f), static_cast<float>(width) / height, 0.1f, 100.f)
+                    * glm::lookAt(view_pos, glm::vec3 { 0.f }, glm::vec3 { 0.f, 1.f, 0.f }),
+            };
+        };
+        const MvpMatrixUniform mvp_matrix = make_mvp_matrix(width, height);
+        const LightingUniform lighting { .view_pos = view_pos, .light_pos = view_pos };
+        const std::filesystem::path reference_path = std::filesystem::temp_directory_path() / "icosphere_benchmark_raster.ppm";
+
+        const auto make_flat_vertices = [](const Mesh<std::uint32_t> &mesh){
+            std::vector<Vertex> flat_vertices;
+            flat_vertices.reserve(3 * mesh.triangle_indices.size());
+            for (const Triangle &triangle : mesh.getTriangles()){
+                const glm::vec3 normal = triangle.normal();
+                flat_vertices.emplace_back(triangle.p1, normal);
+                flat_vertices.emplace_back(triangle.p2, normal);
+                flat_vertices.emplace_back(triangle.p3, normal);
+            }
+            return flat_vertices;
+        };
+
+        /*
+         * Regression test against the checked-in golden images. They must be regenerated (by running with the
+         * ICOSPHERE_UPDATE_GOLDEN environment variable set) only if the rendering is intentionally changed.
+         */
+        bool passed = true;
+        {
+            const auto mesh = Icosphere<std::uint32_t>::generate(2);
+            const std::vector<Vertex> flat_vertices = make_flat_vertices(mesh);
+            const MvpMatrixUniform golden_mvp_matrix = make_mvp_matrix(golden_size, golden_size);
+            const bool update_golden = std::getenv("ICOSPHERE_UPDATE_GOLDEN") != nullptr;
+
+            const auto check_golden = [&](const char *mode, auto &&draw){
+                SoftwareRasterizer rasterizer { golden_size, golden_size };
+                rasterizer.clear();
+                draw(rasterizer);
+
+                const std::filesystem::path golden_path = std::filesystem::path { ICOSPHERE_GOLDEN_DIR } / ("raster_" + std::string { mode } + ".ppm");
+                if (update_golden){
+                    writePpm(golden_path, rasterizer.getImage());
+                }
+                const ImageDifference difference = compareImages(rasterizer.getImage(), readPpm(golden_path), golden_channel_tolerance);
+                std::printf("%6s %12zu %12d\n", mode, difference.num_different_pixels, difference.max_difference);
+                passed &= difference.num_different_pixels == 0;
+            };
+
+            std::printf("%6s %12s %12s\n", "golden", "diff(px)", "max diff");
+            check_golden("flat", [&](SoftwareRasterizer &rasterizer){ rasterizer.drawFlat(flat_vertices, golden_mvp_matrix, lighting); });
+            check_golden("phong", [&](SoftwareRasterizer &rasterizer){ rasterizer.drawPhong(mesh, golden_mvp_matrix, lighting); });
+        }
+
+        std::vector<unsigned> num_threads_list = thread_counts();
+        if (num_threads_list.back() < min_checked_threads){
+            num_threads_list.push_back(min_checked_threads);
+        }
+
+        std::printf("%5s %6s %8s %12s %12s %10s %14s %14s %10s\n",
+                    "level", "mode", "threads", "triangles", "fragments", "time(ms)", "Mtriangles/s", "Mpixels/s", "diff(px)");
+        for (std::uint8_t level = 2; level <= 8; level += 2){
+            const auto mesh = Icosphere<std::uint32_t>::generate(level);
+            const std::vector<Vertex> flat_vertices = make_flat_vertices(mesh);
+
+            const auto draw_flat = [&](SoftwareRasterizer &rasterizer){ return rasterizer.drawFlat(flat_vertices, mvp_matrix, lighting); };
+            const auto draw_phong = [&](SoftwareRasterizer &rasterizer){ return rasterizer.drawPhong(mesh, mvp_matrix, lighting); };
+
+            // Reference image rendered by a single thread, round-tripped through PPM.
+            const auto render_reference = [&](auto &&draw){
+                SoftwareRasterizer rasterizer { width, height, 1 };
+                rasterizer.clear();
+                draw(rasterizer);
+                writePpm(reference_path, rasterizer.getImage());
+                return readPpm(reference_path);
+            };
+            const Image flat_reference = render_reference(draw_flat), phong_reference = render_reference(draw_phong);
+
+            for (unsigned num_threads : num_threads_list){
+                SoftwareRasterizer rasterizer { width, height, num_threads };
+                // The output must not depend on the thread count, therefore no pixel may differ from the reference.
+                const auto run = [&](const char *mode, auto &&draw, const Image &reference){
+                    SoftwareRasterizer::Statistics statistics;
+                    const auto elapsed = measure_average([&]{
+                        rasterizer.clear();
+                        statistics = draw(rasterizer);
+                    });
+                    const ImageDifference difference = compareImages(rasterizer.getImage(), reference);
+
+                    const double seconds = std::chrono::duration<double>(elapsed).count();
+                    std::printf("%5d %6s %8u %12zu %12zu %10.3f %14.3f %14.3f %10zu\n",
+                                level, mode, num_threads, statistics.num_triangles, statistics.num_fragments, elapsed.count(),
+                                statistics.num_triangles / seconds * 1e-6, statistics.num_fragments / seconds * 1e-6,
+                                difference.num_different_pixels);
+                    passed &= difference.num_different_pixels == 0;
+                };
+
+                run("flat", draw_flat, flat_reference);
+                run("phong", draw_phong, phong_reference);
+            }
+        }
+        std::filesystem::remove(reference_path);
+        return passed;
+    }
+
+    bool benchmarkBvh(){
+        constexpr int image_size = 512; // Primary rays are cast from a camera for image_size x image_size pixels.
+        constexpr std::size_t num_ao_points = 32'768, num_ao_rays_per_point = 8;
+        constexpr std::size_t max_checked_tests = std::size_t { 1 } << 26; // Ray-triangle tests of the brute force check per ray set.
+
+        // Closest hit by testing all triangles, with the same (two-sided Möller-Trumbore) test as the BVH.
+        const auto brute_force = [](const Mesh<std::uint32_t> &mesh, const Ray &ray){
+            RayHit hit { ray.t_max, 0.f, 0.f, RayHit::miss };
+            for (std::size_t triangle_index = 0; triangle_index < mesh.triangle_indices.size(); ++triangle_index){
+                const auto [i1, i2, i3] = mesh.triangle_indices[triangle_index];
+                const glm::vec3 e1 = mesh.positions[i2] - mesh.positions[i1], e2 = mesh.positions[i3] - mesh.positions[i1];
+                const glm::vec3 pvec = glm::cross(ray.direction, e2);
+                const float det = glm::dot(e1, pvec);
+                const float inv_det = 1.f / det;
+
+                const glm::vec3 tvec = ray.origin - mesh.positions[i1];
+                const float u = glm::dot(tvec, pvec) * inv_det;
+                const glm::vec3 qvec = glm::cross(tvec, e1);
+                const float v = glm::dot(ray.direction, qvec) * inv_det;
+                const float t = glm::dot(e2, qvec) * inv_det;
+                if (det != 0.f && u >= 0.f && v >= 0.f && u + v <= 1.f && t >= ray.t_min && t < hit.t){
+                    hit = { t, u, v, static_cast<std::uint32_t>(triangle_index) };
+                }
+            }
+            return hit;
+        };
+
+        // Cast rays in packets of N (N = 1 for single ray traversal), and return the elapsed time per ray cast.
+        const auto cast_rays = [](const Bvh &bvh, const std::vector<Ray> &rays, auto packet_size){
+            constexpr std::size_t N = decltype(packet_size)::value;
+            std::atomic<std::size_t> num_hits = 0;
+            const auto elapsed = measure_average([&]{
+                num_hits = 0;
+                parallel_for(std::size_t { 0 }, rays.size() / N, [&](std::size_t first, std::size_t last){
+                    std::size_t thread_num_hits = 0;
+                    for (std::size_t packet_index = first; packet_index < last; ++packet_index){
+                        RayPacket<N> packet;
+                        for (std::size_t lane = 0; lane < N; ++lane){
+                            packet.set(lane, rays[N * packet_index + lane]);
+                        }
+                        const PacketHit<N> hit = bvh.intersect(packet);
+                        thread_num_hits += std::ranges::count_if(hit.triangle_index, [](std::uint32_t index){ return index != RayHit::miss; });
+                    }
+                    num_hits += thread_num_hits;
+                });
+            }, 3);
+            return std::pair { elapsed, num_hits.load() };
+        };
+
+        bool passed = true;
+        std::printf("%5s %10s %10s %10s %6s %8s %12s %12s %12s %10s\n",
+                    "level", "triangles", "build(ms)", "refit(ms)", "rays", "hit(%)", "x1(Mray/s)", "x4(Mray/s)", "x8(Mray/s)", "mismatches");
+        for (std::uint8_t level = 4; level <= 9; ++level){
+            // Displaced icosphere, which is no longer on the unit sphere.
+            const auto sphere_mesh = Icosphere<std::uint32_t>::generate(level);
+            auto mesh = sphere_mesh;
+            for (glm::vec3 &position : mesh.positions){
+                position *= 1.f + 0.1f * std::sin(8.f * position.x) * std::sin(8.f * position.y) * std::sin(8.f * position.z);
+            }
+
+            // The refit BVH is built over the unit sphere, and then refit to the displaced positions.
+            const auto [bvh, build_elapsed] = measure_execution_with_result([&]{ return Bvh::build(mesh); });
+            Bvh refit_bvh = Bvh::build(sphere_mesh);
+            const auto refit_elapsed = measure_execution([&]{ refit_bvh.refit(mesh); });
+
+            // Primary rays, where each packet of 8 is a 4x2 pixel block (2x2 for the first 4 lanes).
+            std::vector<Ray> primary_rays;
+            primary_rays.reserve(image_size * image_size);
+            const glm::vec3 camera_position { 0.f, 0.f, 3.f };
+            for (int block_y = 0; block_y < image_size; block_y += 2){
+                for (int block_x = 0; block_x < image_size; block_x += 4){
+                    for (int offset : { 0, 1, 4, 5, 2, 3, 6, 7 }){
+                        const int x = block_x + offset % 4, y = block_y + offset / 4;
+                        const glm::vec3 target { 2.f * (x + 0.5f) / image_size - 1.f, 2.f * (y + 0.5f) / image_size - 1.f, 1.f };
+                        primary_rays.push_back({ camera_position, glm::normalize(target - camera_position) });
+                    }
+                }
+            }
+
+            // Ambient occlusion rays from random surface points, where rays from the same point are in a packet.
+            std::vector<Ray> ao_rays;
+            ao_rays.reserve(num_ao_points * num_ao_rays_per_point);
+            std::mt19937 random_engine { 0 };
+            std::uniform_int_distribution<std::size_t> triangle_distribution { 0, mesh.triangle_indices.size() - 1 };
+            std::normal_distribution<float> direction_distribution;
+            for (std::size_t point = 0; point < num_ao_points; ++point){
+                const auto [i1, i2, i3] = mesh.triangle_indices[triangle_distribution(random_engine)];
+                const Triangle triangle { mesh.positions[i1], mesh.positions[i2], mesh.positions[i3] };
+                const glm::vec3 origin = (triangle.p1 + triangle.p2 + triangle.p3) / 3.f, normal = triangle.normal();
+                for (std::size_t ray = 0; ray < num_ao_rays_per_point; ++ray){
+                    glm::vec3 direction = glm::normalize(glm::vec3 { direction_distribution(random_engine), direction_distribution(random_engine), direction_distribution(random_engine) });
+                    if (glm::dot(direction, normal) < 0.f){
+                        direction = -direction;
+                    }
+                    ao_rays.push_back({ origin, direction, 1e-4f, 0.5f });
+                }
+            }
+
+            for (const auto &[name, rays] : { std::pair { "prim", &primary_rays }, std::pair { "ao", &ao_rays } }){
+                const auto [elapsed1, num_hits] = cast_rays(bvh, *rays, std::integral_constant<std::size_t, 1>{});
+                const auto [elapsed4, _4] = cast_rays(bvh, *rays, std::integral_constant<std::size_t, 4>{});
+                const auto [elapsed8, _8] = cast_rays(bvh, *rays, std::integral_constant<std::size_t, 8>{});
+                const auto mrays_per_second = [&](std::chrono::duration<double, std::milli> elapsed){
+                    return static_cast<double>(rays->size()) / std::chrono::duration<double>(elapsed).count() * 1e-6;
+                };
+
+                /*
+                 * Accuracy: packets of 8 sampled rays are cast as single rays, 4-wide and 8-wide packets, and by the refit
+                 * BVH, and each lane must have the same closest hit as the brute force. Different triangles with the same
+                 * distance (hits on a shared edge) are not counted as mismatches.
+                 */
+                const std::size_t num_packets = rays->size() / 8,
+                                  num_checked_packets = std::clamp<std::size_t>(max_checked_tests / (8 * mesh.triangle_indices.size()), 1, num_packets);
+                std::size_t num_mismatches = 0;
+                for (std::size_t k = 0; k < num_checked_packets; ++k){
+                    const std::size_t first_ray = 8 * (num_packets * k / num_checked_packets);
+                    RayPacket<8> packet8;
+                    std::array<RayPacket<4>, 2> packets4;
+                    for (std::size_t lane = 0; lane < 8; ++lane){
+                        packet8.set(lane, (*rays)[first_ray + lane]);
+                        packets4[lane / 4].set(lane % 4, (*rays)[first_ray + lane]);
+                    }
+                    const PacketHit<8> hit8 = bvh.intersect(packet8), refit_hit8 = refit_bvh.intersect(packet8);
+                    const std::array hits4 { bvh.intersect(packets4[0]), bvh.intersect(packets4[1]) };
+                    for (std::size_t lane = 0; lane < 8; ++lane){
+                        const RayHit expected = brute_force(mesh, (*rays)[first_ray + lane]);
+                        for (const RayHit &hit : { bvh.intersect((*rays)[first_ray + lane]), hits4[lane / 4][lane % 4], hit8[lane], refit_hit8[lane] }){
+                            num_mismatches += hit.triangle_index != expected.triangle_index && hit.t != expected.t;
+                        }
+                    }
+                }
+
+                std::printf("%5d %10zu %10.3f %10.3f %6s %8.2f %12.3f %12.3f %12.3f %10zu\n",
+                            level, mesh.triangle_indices.size(), build_elapsed.count(), refit_elapsed.count(), name,
+                            100.0 * num_hits / rays->size(),
+                            mrays_per_second(elapsed1), mrays_per_second(elapsed4), mrays_per_second(elapsed8), num_mismatches);
+                passed &= num_mismatches == 0;
+            }
+        }
+        return passed;
+    }
+
+    bool benchmarkDecimation(){
+        // Budgets between the triangle counts of consecutive subdivision levels, and one at a level count for comparison.
+        constexpr std::array<std::pair<std::uint8_t, std::size_t>, 5> cases {{
+            { 5, 10'000 }, { 6, 20'480 }, { 6, 50'000 }, { 7, 100'000 }, { 7, 150'000 },
+        }};
+
+        std::printf("%5s %10s %10s %7s %8s %12s %12s %12s\n",
+                    "level", "triangles", "target", "threads", "passes", "time(ms)", "error", "radial");
+        for (const auto &[level, target_triangles] : cases){
+            const auto mesh = Icosphere<std::uint32_t>::generate(level);
+            for (unsigned num_threads : thread_counts()){
+                const auto [result, elapsed] = measure_execution_with_result([&]{
+                    return Decimation::simplify(mesh, target_triangles, std::numeric_limits<float>::infinity(), num_threads);
+                });
+
+                // Maximum deviation of the triangle centroids from the unit sphere, which the original mesh approximates.
+                float radial_error = 0.f;
+                for (const auto &[i1, i2, i3] : result.mesh.triangle_indices){
+                    const glm::vec3 centroid = (result.mesh.positions[i1] + result.mesh.positions[i2] + result.mesh.positions[i3]) / 3.f;
+                    radial_error = std::max(radial_error, std::abs(1.f - glm::length(centroid)));
+                }
+
+                std::printf("%5d %10zu %10zu %7u %8zu %12.3f %12.6f %12.6f\n",
+                            level, result.mesh.triangle_indices.size(), target_triangles, num_threads, result.num_passes,
+                            elapsed.count(), result.error, radial_error);
+            }
+        }
+        return true;
+    }
+
+    bool benchmarkGeodesic(){
+        using icosphere_t = Icosphere<std::uint32_t>;
+        using triangle_index_t = Mesh<std::uint32_t>::triangle_index_t;
+        constexpr std::array<std::uint32_t, 8> frequencies { 12, 23, 64, 100, 128, 256, 500, 1024 };
+
+        const auto position_less = [](const glm::vec3 &lhs, const glm::vec3 &rhs){
+            return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+        };
+        // Rotate the triangle indices so that the smallest one is the first, keeping the orientation.
+        const auto canonical_triangle = [](const triangle_index_t &triangle){
+            const auto rotation = std::ranges::min_element(triangle) - triangle.begin();
+            return triangle_index_t { triangle[rotation], triangle[(rotation + 1) % 3], triangle[(rotation + 2) % 3] };
+        };
+
+        /*
+         * For a power of two frequency, the mesh must be bitwise identical to generate() up to the order of positions and
+         * triangles. Returns the number of positions not found in the generated mesh and triangles not matched.
+         */
+        const auto count_generate_mismatches = [&](const Mesh<std::uint32_t> &geodesic, const Mesh<std::uint32_t> &generated){
+            if (geodesic.positions.size() != generated.positions.size() || geodesic.triangle_indices.size() != generated.triangle_indices.size()){
+                return std::max(geodesic.positions.size(), generated.positions.size()) + std::max(geodesic.triangle_indices.size(), generated.triangle_indices.size());
+            }
+
+            std::vector<std::uint32_t> sorted_indices(generated.positions.size());
+            std::iota(sorted_indices.begin(), sorted_indices.end(), 0U);
+            std::ranges::sort(sorted_indices, position_less, [&](std::uint32_t index){ return generated.positions[index]; });
+
+            std::size_t num_mismatches = 0;
+            std::vector<std::uint32_t> generated_indices(geodesic.positions.size());
+            for (std::size_t index = 0; index < geodesic.positions.size(); ++index){
+                const auto it = std::ranges::lower_bound(sorted_indices, geodesic.positions[index], position_less, [&](std::uint32_t index){ return generated.positions[index]; });
+                if (it == sorted_indices.end() || generated.positions[*it] != geodesic.positions[index]){
+                    ++num_mismatches;
+                    continue;
+                }
+                generated_indices[index] = *it;
+            }
+
+            std::vector<triangle_index_t> geodesic_triangles(geodesic.triangle_indices.size()), generated_triangles(generated.triangle_indices.size());
+            std::ranges::transform(geodesic.triangle_indices, geodesic_triangles.begin(), [&](const triangle_index_t &triangle){
+                return canonical_triangle({ generated_indices[triangle[0]], generated_indices[triangle[1]], generated_indices[triangle[2]] });
+            });
+            std::ranges::transform(generated.triangle_indices, generated_triangles.begin(), canonical_triangle);
+            std::ranges::sort(geodesic_triangles);
+            std::ranges::sort(generated_triangles);
+            for (std::size_t i = 0; i < geodesic_triangles.size(); ++i){
+                num_mismatches += geodesic_triangles[i] != generated_triangles[i];
+            }
+            return num_mismatches;
+        };
+
+        /*
+         * For any frequency, the mesh must be a closed 2-manifold sphere (every directed edge appears once with its
+         * reverse, and V - E + F = 2) with unit length positions. Returns the number of violations.
+         */
+        const auto count_manifold_errors = [](const Mesh<std::uint32_t> &mesh){
+            std::size_t num_errors = std::ranges::count_if(mesh.positions, [](const glm::vec3 &position){
+                return std::abs(glm::length(position) - 1.f) > 1e-6f;
+            });
+
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+            edges.reserve(3 * mesh.triangle_indices.size());
+            for (const auto &[i1, i2, i3] : mesh.triangle_indices){
+                edges.insert(edges.end(), { { i1, i2 }, { i2, i3 }, { i3, i1 } });
+            }
+            std::ranges::sort(edges);
+            const auto duplicates = std::ranges::unique(edges);
+            num_errors += duplicates.size();
+            edges.erase(duplicates.begin(), duplicates.end());
+            for (const auto &[from, to] : edges){
+                num_errors += !std::ranges::binary_search(edges, std::pair { to, from });
+            }
+
+            const auto euler_characteristic = static_cast<long long>(mesh.positions.size()) - static_cast<long long>(edges.size() / 2)
+                                            + static_cast<long long>(mesh.triangle_indices.size());
+            return num_errors + static_cast<std::size_t>(std::abs(euler_characteristic - 2));
+        };
+
+        bool passed = true;
+        std::printf("%9s %12s %7s %12s %12s %14s %8s\n",
+                    "frequency", "triangles", "threads", "time(ms)", "Mtri/s", "generate(ms)", "errors");
+        for (std::uint32_t frequency : frequencies){
+            // Recursive generation of the same mesh, if the frequency is a power of two.
+            std::optional<Mesh<std::uint32_t>> generated;
+            double generate_elapsed = std::numeric_limits<double>::quiet_NaN();
+            if (std::has_single_bit(frequency)){
+                const auto [mesh, elapsed] = measure_execution_with_result<double>([&]{
+                    return icosphere_t::generate(static_cast<std::uint8_t>(std::countr_zero(frequency)));
+                });
+                generated.emplace(std::move(mesh));
+                generate_elapsed = elapsed.count();
+            }
+
+            const auto geodesic = icosphere_t::generateGeodesic(frequency);
+            const std::size_t num_errors = generated ? count_generate_mismatches(geodesic, *generated) : count_manifold_errors(geodesic);
+            passed &= num_errors == 0;
+
+            for (unsigned num_threads : thread_counts()){
+                const auto elapsed = measure_average([&]{ return icosphere_t::generateGeodesic(frequency, num_threads); }, 3);
+                const std::size_t num_triangles = icosphere_t::numGeodesicTriangles(frequency);
+                std::printf("%9u %12zu %7u %12.3f %12.3f %14.3f %8zu\n",
+                            frequency, num_triangles, num_threads, elapsed.count(),
+                            static_cast<double>(num_triangles) / std::chrono::duration<double>(elapsed).count() * 1e-6,
+                            generate_elapsed, num_errors);
+            }
+        }
+        return passed;
+    }
+
+    bool benchmarkExport(){
+        constexpr std::uint32_t frequency = 256; // 1,310,720 triangles, same as level 8.
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "icosphere_benchmark_export";
+        const auto mesh = Icosphere<std::uint32_t>::generateGeodesic(frequency);
+
+        constexpr std::array<std::pair<MeshFormat, const char*>, 3> formats {{
+            { MeshFormat::PlyBinary, "ply-bin" }, { MeshFormat::PlyAscii, "ply-ascii" }, { MeshFormat::Obj, "obj" },
+        }};
+
+        std::printf("%10s %10s %7s %10s %12s %10s %10s\n", "format", "source", "threads", "MB", "time(ms)", "MB/s", "identical");
+        const auto print = [](const char *format_name, const char *source, unsigned num_threads, const ExportResult &result, const char *identical){
+            std::printf("%10s %10s %7u %10.3f %12.3f %10.3f %10s\n",
+                        format_name, source, num_threads, static_cast<double>(result.bytes) * 1e-6, result.elapsed.count(), result.megabytesPerSecond(), identical);
+        };
+
+        // Ad-hoc iostream dump of OBJ, for comparison.
+        const auto [iostream_bytes, iostream_elapsed] = measure_execution_with_result<double>([&]{
+            std::ofstream file { path, std::ios::binary };
+            file.precision(9);
+            for (const glm::vec3 &position : mesh.positions){
+                file << "v " << position.x << ' ' << position.y << ' ' << position.z << '\n';
+            }
+            for (const auto &[i1, i2, i3] : mesh.triangle_indices){
+                file << "f " << i1 + 1 << ' ' << i2 + 1 << ' ' << i3 + 1 << '\n';
+            }
+            return static_cast<std::size_t>(file.tellp());
+        });
+        print("obj", "iostream", 1, ExportResult { iostream_bytes, iostream_elapsed }, "-");
+
+        // Accuracy: the single thread mesh export must read back as the mesh, and every other export (streamed or with
+        // more threads, including 4 threads on a single core machine) must be byte identical to it.
+        std::vector<unsigned> num_threads_list = thread_counts();
+        if (num_threads_list.size() == 1){
+            num_threads_list.push_back(4);
+        }
+        bool passed = true;
+        for (const auto &[format, format_name] : formats){
+            std::string reference;
+            for (unsigned num_threads : num_threads_list){
+                const ExportResult mesh_result = MeshExport::writeMesh(path, mesh, format, { .num_threads = num_threads });
+                std::string bytes = read_file(path);
+                if (reference.empty()){
+                    reference = std::move(bytes);
+                    const std::size_t num_mismatches = count_readback_mismatches(reference, format, mesh);
+                    passed &= num_mismatches == 0 && reference.size() == mesh_result.bytes;
+                    print(format_name, "mesh", num_threads, mesh_result, num_mismatches == 0 ? "read back" : "NO");
+                }
+                else{
+                    passed &= bytes == reference;
+                    print(format_name, "mesh", num_threads, mesh_result, bytes == reference ? "yes" : "NO");
+                }
+
+                const ExportResult streamed_result = MeshExport::writeGeodesic(path, frequency, format, { .num_threads = num_threads });
+                const bool identical = read_file(path) == reference;
+                passed &= identical;
+                print(format_name, "streamed", num_threads, streamed_result, identical ? "yes" : "NO");
+            }
+        }
+        std::filesystem::remove(path);
+        return passed;
+    }
+
+    bool benchmarkRandomAccess(){
+        using icosphere_t = Icosphere<std::uint32_t>;
+        constexpr std::size_t num_queries = 1'000'000, max_num_checked = 1'000'000;
+        constexpr std::uint8_t patch_depth = 6; // Patches of 4^6 triangles.
+
+        bool passed = true;
+        std::printf("%5s %12s %14s %12s %12s %12s %12s %9s %9s %9s %9s\n",
+                    "level", "triangles", "generate(ms)", "tri(M/s)", "vertex(M/s)", "nbr(M/s)", "patch(us)", "tri err", "nbr err", "loc err", "vtx err");
+        for (std::uint8_t level : { 6, 8, 10 }){
+            const auto [mesh, generate_elapsed] = measure_execution_with_result([&]{ return icosphere_t::generate(level); });
+
+            std::mt19937_64 random_engine { level };
+            std::uniform_int_distribution<std::size_t> triangle_distribution { 0, mesh.triangle_indices.size() - 1 };
+            std::vector<std::size_t> triangle_indices(num_queries);
+            std::ranges::generate(triangle_indices, [&]{ return triangle_distribution(random_engine); });
+            std::vector<GridCoordinate> vertices(num_queries);
+            std::ranges::transform(triangle_indices, vertices.begin(), [&](std::size_t triangle_index){
+                return icosphere_t::triangleGrid(level, triangle_index)[triangle_index % 3];
+            });
+
+            // Run the query for each input in parallel, and return the queries per second (in millions).
+            const auto throughput = [](const auto &inputs, auto &&query){
+                std::atomic<float> checksum = 0.f; // Keep the results alive.
+                const auto elapsed = measure_average([&]{
+                    parallel_for(std::size_t { 0 }, inputs.size(), [&](std::size_t first, std::size_t last){
+                        float sum = 0.f;
+                        for (std::size_t i = first; i < last; ++i){
+                            sum += query(inputs[i]);
+                        }
+                        checksum.fetch_add(sum, std::memory_order_relaxed);
+                    });
+                }, 3);
+                return static_cast<double>(inputs.size()) / std::chrono::duration<double>(elapsed).count() * 1e-6;
+            };
+            const double triangle_throughput = throughput(triangle_indices, [&](std::size_t triangle_index){
+                return icosphere_t::triangle(level, triangle_index).p1.x;
+            });
+            const double vertex_throughput = throughput(vertices, [&](const GridCoordinate &coordinate){
+                return icosphere_t::vertexPosition(level, coordinate).x;
+            });
+            const double neighbor_throughput = throughput(triangle_indices, [&](std::size_t triangle_index){
+                return static_cast<float>(icosphere_t::triangleNeighbors(level, triangle_index)[0]);
+            });
+
+            // Patch around a view direction, enumerated lazily.
+            const std::uint8_t patch_level = level - patch_depth;
+            const auto patch_elapsed = measure_average([&]{
+                float sum = 0.f;
+                for (const Triangle &triangle : icosphere_t::patch(level, patch_level, icosphere_t::locate(patch_level, { 0.3f, 0.5f, 0.8f }))){
+                    sum += triangle.p1.x;
+                }
+                return sum;
+            });
+
+            // Accuracy (checked for all or sampled triangles/vertices):
+            // - triangle positions must be bitwise identical to the generated mesh,
+            // - neighbors must match the half-edge map of the generated mesh,
+            // - locate must find each triangle from its centroid,
+            // - vertex coordinates must map back to the same geodesic index and position.
+            const std::size_t num_checked = std::min(mesh.triangle_indices.size(), max_num_checked);
+            const auto checked_triangle = [&](std::size_t k){
+                return num_checked == mesh.triangle_indices.size() ? k : triangle_indices[k];
+            };
+
+            std::size_t num_position_mismatches = 0, num_locate_mismatches = 0;
+            for (std::size_t k = 0; k < num_checked; ++k){
+                const std::size_t triangle_index = checked_triangle(k);
+                const auto [i1, i2, i3] = mesh.triangle_indices[triangle_index];
+                const Triangle triangle = icosphere_t::triangle(level, triangle_index);
+                if (triangle.p1 != mesh.positions[i1] || triangle.p2 != mesh.positions[i2] || triangle.p3 != mesh.positions[i3]){
+                    ++num_position_mismatches;
+                }
+                const glm::vec3 centroid = (mesh.positions[i1] + mesh.positions[i2] + mesh.positions[i3]) / 3.f;
+                num_locate_mismatches += icosphere_t::locate(level, centroid) != triangle_index;
+            }
+
+            // The neighbor across the edge (a, b) of a checked triangle owns the half-edge (b, a). The wanted half-edges are
+            // bucketed by their origin vertex, and their owners are found in one pass over all triangles.
+            std::size_t num_neighbor_mismatches = 0;
+            {
+                std::vector<std::size_t> half_edge_offsets(mesh.positions.size() + 1, 0);
+                for (std::size_t k = 0; k < num_checked; ++k){
+                    for (std::uint32_t origin : mesh.triangle_indices[checked_triangle(k)]){
+                        ++half_edge_offsets[origin + 1];
+                    }
+                }
+                std::inclusive_scan(half_edge_offsets.begin(), half_edge_offsets.end(), half_edge_offsets.begin());
+
+                struct HalfEdgeQuery{ std::uint32_t target; std::size_t slot; };
+                std::vector<HalfEdgeQuery> half_edge_queries(3 * num_checked);
+                std::vector<std::size_t> query_cursors(half_edge_offsets.begin(), half_edge_offsets.end() - 1);
+                for (std::size_t k = 0; k < num_checked; ++k){
+                    const auto &indices = mesh.triangle_indices[checked_triangle(k)];
+                    for (std::size_t edge = 0; edge < 3; ++edge){
+                        half_edge_queries[query_cursors[indices[(edge + 1) % 3]]++] = { indices[edge], 3 * k + edge };
+                    }
+                }
+
+                std::vector<std::size_t> expected_neighbors(3 * num_checked, mesh.triangle_indices.size());
+                for (std::size_t triangle_index = 0; triangle_index < mesh.triangle_indices.size(); ++triangle_index){
+                    const auto &indices = mesh.triangle_indices[triangle_index];
+                    for (std::size_t edge = 0; edge < 3; ++edge){
+                        const std::uint32_t origin = indices[edge], target = indices[(edge + 1) % 3];
+                        for (std::size_t q = half_edge_offsets[origin]; q < half_edge_offsets[origin + 1]; ++q){
+                            if (half_edge_queries[q].target == target){
+                                expected_neighbors[half_edge_queries[q].slot] = triangle_index;
+                            }
+                        }
+                    }
+                }
+
+                for (std::size_t k = 0; k < num_checked; ++k){
+                    const auto neighbors = icosphere_t::triangleNeighbors(level, checked_triangle(k));
+                    num_neighbor_mismatches += !std::equal(neighbors.begin(), neighbors.end(), expected_neighbors.begin() + 3 * k);
+                }
+            }
+
+            std::size_t num_vertex_mismatches = 0;
+            {
+                const auto geodesic = icosphere_t::generateGeodesic(std::uint32_t { 1 } << level);
+                const std::size_t num_checked_vertices = std::min(geodesic.positions.size(), max_num_checked);
+                std::uniform_int_distribution<std::size_t> vertex_distribution { 0, geodesic.positions.size() - 1 };
+                for (std::size_t k = 0; k < num_checked_vertices; ++k){
+                    const std::size_t vertex_index = num_checked_vertices == geodesic.positions.size() ? k : vertex_distribution(random_engine);
+                    const GridCoordinate coordinate = icosphere_t::vertexCoordinate(level, vertex_index);
+                    if (icosphere_t::vertexIndex(level, coordinate) != vertex_index
+                        || icosphere_t::vertexPosition(level, coordinate) != geodesic.positions[vertex_index]){
+                        ++num_vertex_mismatches;
+                    }
+                }
+            }
+            passed &= num_position_mismatches == 0 && num_neighbor_mismatches == 0 && num_locate_mismatches == 0 && num_vertex_mismatches == 0;
+
+            std::printf("%5d %12zu %14.3f %12.3f %12.3f %12.3f %12.3f %9zu %9zu %9zu %9zu\n",
+                        level, mesh.triangle_indices.size(), generate_elapsed.count(),
+                        triangle_throughput, vertex_throughput, neighbor_throughput,
+                        std::chrono::duration<double, std::micro>(patch_elapsed).count(),
+                        num_position_mismatches, num_neighbor_mismatches, num_locate_mismatches, num_vertex_mismatches);
+        }
+        return passed;
+    }
+
+    struct Benchmark{
+        const char *name;
+        bool (*run)(); // Returns false if an accuracy check failed.
+    };
+
+    constexpr std::array benchmarks {
+        Benchmark { "laplacian", benchmarkLaplacian },
+        Benchmark { "instancing", benchmarkInstancing },
+        Benchmark { "index", benchmarkIndexType },
+        Benchmark { "raster", benchmarkRasterizer },
+        Benchmark { "bvh", benchmarkBvh },
+        Benchmark { "decimate", benchmarkDecimation },
+        Benchmark { "geodesic", benchmarkGeodesic },
+        Benchmark { "export", benchmarkExport },
+        Benchmark { "access", benchmarkRandomAccess },
+    };
+}
+
+int main(int argc, char **argv){
+    // Run all benchmarks if no name is given, otherwise run only the given ones.
+    bool passed = true;
+    for (const Benchmark &benchmark : benchmarks){
+        if (argc == 1 || std::any_of(argv + 1, argv + argc, [&](const char *name){ return std::strcmp(name, benchmark.name) == 0; })){
+            std::printf("[%s]\n", benchmark.name);
+            if (!benchmark.run()){
+                std::fprintf(stderr, "[%s] accuracy check failed.\n", benchmark.name);
+                passed = false;
+            }
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,479 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+
+#include <parallel_for.hpp>
+
+#include "icosphere.hpp"
+
+struct Ray{
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float t_min = 0.f;
+    float t_max = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * Closest hit of a ray, where the hit point is <tt>(1 - u - v) * p1 + u * p2 + v * p3</tt> of the triangle.
+ */
+struct RayHit{
+    static constexpr std::uint32_t miss = std::numeric_limits<std::uint32_t>::max();
+
+    float t = std::numeric_limits<float>::infinity();
+    float u = 0.f, v = 0.f;
+    std::uint32_t triangle_index = miss; // Index of Mesh::triangle_indices, or miss.
+
+    [[nodiscard]] constexpr bool hasHit() const noexcept{
+        return triangle_index != miss;
+    }
+};
+
+/**
+ * \p N rays in structure-of-arrays layout, so that each ray is processed in a SIMD lane. Rays in a packet should be
+ * coherent (e.g. neighboring pixels, or rays from the same point) for efficient traversal.
+ */
+template <std::size_t N>
+struct RayPacket{
+    std::array<float, N> origin_x, origin_y, origin_z;
+    std::array<float, N> direction_x, direction_y, direction_z;
+    std::array<float, N> t_min, t_max;
+
+    constexpr void set(std::size_t lane, const Ray &ray) noexcept{
+        origin_x[lane] = ray.origin.x; origin_y[lane] = ray.origin.y; origin_z[lane] = ray.origin.z;
+        direction_x[lane] = ray.direction.x; direction_y[lane] = ray.direction.y; direction_z[lane] = ray.direction.z;
+        t_min[lane] = ray.t_min; t_max[lane] = ray.t_max;
+    }
+};
+
+template <std::size_t N>
+struct PacketHit{
+    std::array<float, N> t, u, v;
+    std::array<std::uint32_t, N> triangle_index;
+
+    [[nodiscard]] constexpr RayHit operator[](std::size_t lane) const noexcept{
+        return { t[lane], u[lane], v[lane], triangle_index[lane] };
+    }
+};
+
+/**
+ * Bounding volume hierarchy over the triangles of a mesh, built with binned surface area heuristic (SAH).
+ *
+ * The mesh does not need to be on the unit sphere. If the positions are changed but the triangle indices are kept
+ * (e.g. displaced icosphere), \p refit() updates the bounds in linear time without rebuilding the hierarchy.
+ *
+ * @code
+ * auto mesh = Icosphere<std::uint32_t>::generate(6);
+ * const auto bvh = Bvh::build(mesh);
+ * const RayHit hit = bvh.intersect(Ray { origin, direction });
+ * if (hit.hasHit()){
+ *     const auto [i1, i2, i3] = mesh.triangle_indices[hit.triangle_index];
+ * }
+ * @endcode
+ */
+class Bvh{
+public:
+    struct Node{
+        glm::vec3 bounds_min;
+        std::uint32_t first; // Left child index for inner node (right child is first + 1), or first triangle for leaf.
+        glm::vec3 bounds_max;
+        std::uint32_t count; // 0 for inner node, the number of triangles for leaf.
+
+        [[nodiscard]] constexpr bool isLeaf() const noexcept{
+            return count != 0;
+        }
+    };
+
+private:
+    static constexpr std::size_t num_bins = 16;
+    static constexpr std::uint32_t min_leaf_size = 4, max_leaf_size = 8;
+    static constexpr std::uint32_t parallel_threshold = 4096; // Subtrees smaller than this are built in a single thread.
+    static constexpr float traversal_cost = 1.f, intersection_cost = 1.f;
+    static constexpr std::size_t max_stack_size = 64; // Deeper trees use a traversal stack on the heap.
+
+    std::vector<Node> nodes;
+    std::uint32_t max_depth = 0; // Depth of the deepest leaf (0 for the root).
+    std::vector<std::uint32_t> triangle_indices; // Original triangle index of each leaf triangle.
+    std::vector<Triangle> triangles; // Triangle positions in leaf order.
+
+    struct Bounds{
+        glm::vec3 min { std::numeric_limits<float>::infinity() };
+        glm::vec3 max { -std::numeric_limits<float>::infinity() };
+
+        constexpr void extend(const glm::vec3 &point) noexcept{
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        constexpr void extend(const Bounds &bounds) noexcept{
+            min = glm::min(min, bounds.min);
+            max = glm::max(max, bounds.max);
+        }
+
+        [[nodiscard]] constexpr float halfArea() const noexcept{
+            const glm::vec3 extent = max - min;
+            return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+        }
+    };
+
+    static Bounds triangleBounds(const Triangle &triangle) noexcept{
+        Bounds bounds;
+        bounds.extend(triangle.p1);
+        bounds.extend(triangle.p2);
+        bounds.extend(triangle.p3);
+        return bounds;
+    }
+
+    /*
+     * Primitives are partitioned in place together with their bounds and centroids, so that each node reads a
+     * contiguous range of memory.
+     */
+    struct BuildPrimitive{
+        Bounds bounds;
+        glm::vec3 centroid;
+        std::uint32_t triangle_index;
+    };
+
+    struct Builder{
+        Bvh &bvh;
+        std::vector<BuildPrimitive> primitives;
+        std::atomic<std::uint32_t> num_nodes { 1 };
+        std::atomic<std::uint32_t> max_depth { 0 };
+        unsigned max_parallel_depth;
+
+        void build(std::uint32_t node_index, std::uint32_t first, std::uint32_t count, unsigned depth){
+            Node &node = bvh.nodes[node_index];
+
+            Bounds node_bounds, centroid_bounds;
+            for (std::uint32_t i = first; i < first + count; ++i){
+                node_bounds.extend(primitives[i].bounds);
+                centroid_bounds.extend(primitives[i].centroid);
+            }
+            node.bounds_min = node_bounds.min;
+            node.bounds_max = node_bounds.max;
+
+            const auto make_leaf = [&]{
+                node.first = first;
+                node.count = count;
+                for (std::uint32_t current = max_depth.load(std::memory_order_relaxed);
+                     current < depth && !max_depth.compare_exchange_weak(current, depth, std::memory_order_relaxed);){ }
+            };
+            if (count <= min_leaf_size){
+                return make_leaf();
+            }
+
+            // Find the best split among all axes and bin boundaries.
+            float best_cost = std::numeric_limits<float>::infinity();
+            int best_axis = -1;
+            std::size_t best_split = 0;
+            for (int axis = 0; axis < 3; ++axis){
+                const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+                if (extent <= 0.f){
+                    continue;
+                }
+
+                std::array<Bounds, num_bins> bin_bounds;
+                std::array<std::uint32_t, num_bins> bin_counts {};
+                const float scale = num_bins / extent;
+                for (std::uint32_t i = first; i < first + count; ++i){
+                    const std::size_t bin = std::min(static_cast<std::size_t>((primitives[i].centroid[axis] - centroid_bounds.min[axis]) * scale), num_bins - 1);
+                    bin_bounds[bin].extend(primitives[i].bounds);
+                    ++bin_counts[bin];
+                }
+
+                // Sweep from the right to get the right side costs, then from the left.
+                std::array<float, num_bins> right_costs;
+                Bounds right_bounds;
+                std::uint32_t right_count = 0;
+                for (std::size_t bin = num_bins - 1; bin > 0; --bin){
+                    right_bounds.extend(bin_bounds[bin]);
+                    right_count += bin_counts[bin];
+                    right_costs[bin] = right_count == 0 ? 0.f : right_bounds.halfArea() * right_count;
+                }
+
+                Bounds left_bounds;
+                std::uint32_t left_count = 0;
+                for (std::size_t split = 1; split < num_bins; ++split){
+                    left_bounds.extend(bin_bounds[split - 1]);
+                    left_count += bin_counts[split - 1];
+                    if (left_count == 0 || left_count == count){
+                        continue;
+                    }
+
+                    const float cost = left_bounds.halfArea() * left_count + right_costs[split];
+                    if (cost < best_cost){
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = split;
+                    }
+                }
+            }
+
+            best_cost = traversal_cost + intersection_cost * best_cost / node_bounds.halfArea();
+            if (best_axis == -1 || (count <= max_leaf_size && best_cost >= intersection_cost * count)){
+                return make_leaf();
+            }
+
+            const float scale = num_bins / (centroid_bounds.max[best_axis] - centroid_bounds.min[best_axis]);
+            const auto middle = std::partition(
+                primitives.begin() + first, primitives.begin() + first + count,
+                [&](const BuildPrimitive &primitive){
+                    const std::size_t bin = std::min(static_cast<std::size_t>((primitive.centroid[best_axis] - centroid_bounds.min[best_axis]) * scale), num_bins - 1);
+                    return bin < best_split;
+                });
+            const auto left_count = static_cast<std::uint32_t>(middle - (primitives.begin() + first));
+
+            const std::uint32_t left_index = num_nodes.fetch_add(2);
+            node.first = left_index;
+            node.count = 0;
+
+            if (count >= parallel_threshold && depth < max_parallel_depth){
+                std::jthread left_thread { [&, left_index, first, left_count, depth]{ build(left_index, first, left_count, depth + 1); } };
+                build(left_index + 1, first + left_count, count - left_count, depth + 1);
+            }
+            else{
+                build(left_index, first, left_count, depth + 1);
+                build(left_index + 1, first + left_count, count - left_count, depth + 1);
+            }
+        }
+    };
+
+    template <std::size_t N>
+    static void intersectTriangle(const Triangle &triangle, std::uint32_t triangle_index, const RayPacket<N> &packet,
+                                  PacketHit<N> &hit) noexcept
+    {
+        // Möller-Trumbore, two-sided.
+        const glm::vec3 e1 = triangle.p2 - triangle.p1, e2 = triangle.p3 - triangle.p1;
+        for (std::size_t lane = 0; lane < N; ++lane){
+            const glm::vec3 direction { packet.direction_x[lane], packet.direction_y[lane], packet.direction_z[lane] };
+            const glm::vec3 pvec = glm::cross(direction, e2);
+            const float det = glm::dot(e1, pvec);
+            const float inv_det = 1.f / det;
+
+            const glm::vec3 tvec = glm::vec3 { packet.origin_x[lane], packet.origin_y[lane], packet.origin_z[lane] } - triangle.p1;
+            const float u = glm::dot(tvec, pvec) * inv_det;
+            const glm::vec3 qvec = glm::cross(tvec, e1);
+            const float v = glm::dot(direction, qvec) * inv_det;
+            const float t = glm::dot(e2, qvec) * inv_det;
+
+            const bool is_hit = det != 0.f && u >= 0.f && v >= 0.f && u + v <= 1.f
+                             && t >= packet.t_min[lane] && t < hit.t[lane];
+            hit.t[lane] = is_hit ? t : hit.t[lane];
+            hit.u[lane] = is_hit ? u : hit.u[lane];
+            hit.v[lane] = is_hit ? v : hit.v[lane];
+            hit.triangle_index[lane] = is_hit ? triangle_index : hit.triangle_index[lane];
+        }
+    }
+
+public:
+    /**
+     * Build the BVH over the triangles of the mesh. Large subtrees are built in parallel.
+     * @param mesh Mesh to be built. The BVH copies the triangle positions, so the mesh does not need to outlive it.
+     * @param num_threads Maximum number of threads to be used (0 is treated as 1).
+     */
+    template <typename IndexType>
+    static Bvh build(const Mesh<IndexType> &mesh, unsigned num_threads = default_thread_count()){
+        Bvh bvh;
+        const auto num_triangles = static_cast<std::uint32_t>(mesh.triangle_indices.size());
+        if (num_triangles == 0){
+            return bvh;
+        }
+
+        Builder builder {
+            .bvh = bvh,
+            .primitives = std::vector<BuildPrimitive>(num_triangles),
+            .max_parallel_depth = static_cast<unsigned>(std::bit_width(std::max(num_threads, 1U) - 1)),
+        };
+        parallel_for(std::uint32_t { 0 }, num_triangles, [&](std::uint32_t first, std::uint32_t last){
+            for (std::uint32_t i = first; i < last; ++i){
+                const auto [i1, i2, i3] = mesh.triangle_indices[i];
+                const Bounds bounds = triangleBounds({ mesh.positions[i1], mesh.positions[i2], mesh.positions[i3] });
+                builder.primitives[i] = { bounds, (bounds.min + bounds.max) * 0.5f, i };
+            }
+        }, num_threads);
+
+        // A binary tree with n leaves has 2n - 1 nodes.
+        bvh.nodes.resize(2 * num_triangles - 1);
+        builder.build(0, 0, num_triangles, 0);
+        bvh.nodes.resize(builder.num_nodes);
+        bvh.max_depth = builder.max_depth;
+        bvh.nodes.shrink_to_fit();
+
+        bvh.triangle_indices.resize(num_triangles);
+        std::ranges::transform(builder.primitives, bvh.triangle_indices.begin(), &BuildPrimitive::triangle_index);
+
+        bvh.triangles.resize(num_triangles);
+        bvh.refit(mesh, num_threads);
+        return bvh;
+    }
+
+    /**
+     * Update the triangle positions and the node bounds after the mesh positions are changed. The triangle indices must
+     * be the same as those the BVH was built with. The tree quality degrades if the displacement is large.
+     */
+    template <typename IndexType>
+    void refit(const Mesh<IndexType> &mesh, unsigned num_threads = default_thread_count()){
+        assert(mesh.triangle_indices.size() == triangles.size());
+
+        parallel_for(std::size_t { 0 }, triangles.size(), [&](std::size_t first, std::size_t last){
+            for (std::size_t i = first; i < last; ++i){
+                const auto [i1, i2, i3] = mesh.triangle_indices[triangle_indices[i]];
+                triangles[i] = { mesh.positions[i1], mesh.positions[i2], mesh.positions[i3] };
+            }
+        }, num_threads);
+
+        // Children are always allocated after their parent, so the reverse order visits children first.
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it){
+            Bounds bounds;
+            if (it->isLeaf()){
+                for (std::uint32_t i = it->first; i < it->first + it->count; ++i){
+                    bounds.extend(triangleBounds(triangles[i]));
+                }
+            }
+            else{
+                for (const Node &child : { nodes[it->first], nodes[it->first + 1] }){
+                    bounds.extend(Bounds { child.bounds_min, child.bounds_max });
+                }
+            }
+            it->bounds_min = bounds.min;
+            it->bounds_max = bounds.max;
+        }
+    }
+
+    [[nodiscard]] const std::vector<Node> &getNodes() const noexcept{
+        return nodes;
+    }
+
+    /**
+     * @brief Get the depth of the deepest leaf. The binned SAH build does not limit it, so degenerate meshes (e.g. many
+     * coincident or collinear triangles) may be much deeper than log2 of the number of triangles.
+     */
+    [[nodiscard]] std::uint32_t getMaxDepth() const noexcept{
+        return max_depth;
+    }
+
+    /**
+     * Intersect \p N rays with the mesh and get the closest hits. Nodes are traversed once for the whole packet and
+     * skipped only if no ray in the packet can have a closer hit in them.
+     *
+     * @throw std::bad_alloc If the tree is deeper than the fixed-size traversal stack and the heap allocation fails.
+     */
+    template <std::size_t N>
+    [[nodiscard]] PacketHit<N> intersect(const RayPacket<N> &packet) const{
+        PacketHit<N> hit;
+        hit.t = packet.t_max;
+        hit.u.fill(0.f);
+        hit.v.fill(0.f);
+        hit.triangle_index.fill(RayHit::miss);
+
+        std::array<float, N> inv_direction_x, inv_direction_y, inv_direction_z;
+        for (std::size_t lane = 0; lane < N; ++lane){
+            inv_direction_x[lane] = 1.f / packet.direction_x[lane];
+            inv_direction_y[lane] = 1.f / packet.direction_y[lane];
+            inv_direction_z[lane] = 1.f / packet.direction_z[lane];
+        }
+
+        // Returns the smallest entry distance among the lanes which hit the node (infinity if no lane hits).
+        const auto intersect_node = [&](const Node &node) -> float {
+            float min_entry = std::numeric_limits<float>::infinity();
+            for (std::size_t lane = 0; lane < N; ++lane){
+                const float tx1 = (node.bounds_min.x - packet.origin_x[lane]) * inv_direction_x[lane],
+                            tx2 = (node.bounds_max.x - packet.origin_x[lane]) * inv_direction_x[lane],
+                            ty1 = (node.bounds_min.y - packet.origin_y[lane]) * inv_direction_y[lane],
+                            ty2 = (node.bounds_max.y - packet.origin_y[lane]) * inv_direction_y[lane],
+                            tz1 = (node.bounds_min.z - packet.origin_z[lane]) * inv_direction_z[lane],
+                            tz2 = (node.bounds_max.z - packet.origin_z[lane]) * inv_direction_z[lane];
+                const float entry = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), packet.t_min[lane])),
+                            exit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), hit.t[lane]));
+                min_entry = entry <= exit ? std::min(min_entry, entry) : min_entry;
+            }
+            return min_entry;
+        };
+
+        if (nodes.empty()){
+            return hit;
+        }
+
+        /*
+         * Each stack entry keeps the smallest entry distance of its node, which was computed when it was pushed. The
+         * node is skipped if the distance is farther than all closest hits found after that.
+         *
+         * The stack holds at most one pending sibling per ancestor, plus the two children being pushed, therefore
+         * (max_depth + 1) entries are enough. Usual trees fit in the fixed-size array.
+         */
+        struct StackEntry{
+            std::uint32_t node_index;
+            float entry;
+        };
+        const std::size_t stack_capacity = std::size_t { max_depth } + 1;
+        std::array<StackEntry, max_stack_size> local_stack;
+        std::vector<StackEntry> heap_stack;
+        StackEntry *stack = local_stack.data();
+        std::size_t stack_size = 0;
+        if (stack_capacity > max_stack_size){
+            heap_stack.resize(stack_capacity);
+            stack = heap_stack.data();
+        }
+        const auto push = [&](const StackEntry &stack_entry) noexcept{
+            assert(stack_size < stack_capacity);
+            stack[stack_size++] = stack_entry;
+        };
+
+        if (const float entry = intersect_node(nodes[0]); entry != std::numeric_limits<float>::infinity()){
+            push({ 0, entry });
+        }
+
+        while (stack_size != 0){
+            const auto [node_index, entry] = stack[--stack_size];
+            if (entry > std::ranges::max(hit.t)){
+                continue;
+            }
+
+            const Node &node = nodes[node_index];
+            if (node.isLeaf()){
+                for (std::uint32_t i = node.first; i < node.first + node.count; ++i){
+                    intersectTriangle(triangles[i], triangle_indices[i], packet, hit);
+                }
+            }
+            else{
+                // Visit the nearer child first, so that the farther one is more likely to be culled by the hits.
+                StackEntry near { node.first, intersect_node(nodes[node.first]) },
+                           far { node.first + 1, intersect_node(nodes[node.first + 1]) };
+                if (far.entry < near.entry){
+                    std::swap(near, far);
+                }
+                if (far.entry != std::numeric_limits<float>::infinity()){
+                    push(far);
+                }
+                if (near.entry != std::numeric_limits<float>::infinity()){
+                    push(near);
+                }
+            }
+        }
+
+        return hit;
+    }
+
+    /**
+     * Intersect a single ray with the mesh and get the closest hit.
+     */
+    [[nodiscard]] RayHit intersect(const Ray &ray) const{
+        RayPacket<1> packet;
+        packet.set(0, ray);
+        return intersect(packet)[0];
+    }
+};
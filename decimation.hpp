@@ -0,0 +1,456 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/ext/vector_double3.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+
+#include <parallel_for.hpp>
+
+#include "icosphere.hpp"
+
+/**
+ * Result of \p Decimation::simplify().
+ */
+template <typename IndexType>
+struct DecimationResult{
+    Mesh<IndexType> mesh;
+    float error = 0.f; // Maximum geometric error of the collapses (see Decimation::simplify()).
+    std::size_t num_passes = 0; // Number of parallel collapse passes.
+
+    /**
+     * @brief Check if the mesh reached the requested triangle count. It may not, if the error bound stopped the
+     * decimation before that.
+     */
+    [[nodiscard]] constexpr bool reached(std::size_t target_triangles) const noexcept{
+        return mesh.triangle_indices.size() == target_triangles;
+    }
+};
+
+namespace Decimation{
+    namespace details{
+        constexpr std::uint32_t removed = std::numeric_limits<std::uint32_t>::max();
+        constexpr std::uint64_t invalid_key = std::numeric_limits<std::uint64_t>::max();
+        constexpr double min_normal_cosine = 0.2; // Collapses rotating a triangle normal more than this are rejected.
+
+        /*
+         * Symmetric 4x4 error quadric (Garland-Heckbert), Q(p) = p^T A p + 2 b^T p + c. It is the sum of the squared
+         * distances from p to the planes accumulated into the quadric.
+         */
+        struct Quadric{
+            double a00, a01, a02, a11, a12, a22, b0, b1, b2, c;
+
+            static Quadric fromPlane(const glm::dvec3 &normal, double distance) noexcept{
+                return {
+                    normal.x * normal.x, normal.x * normal.y, normal.x * normal.z,
+                    normal.y * normal.y, normal.y * normal.z, normal.z * normal.z,
+                    normal.x * distance, normal.y * distance, normal.z * distance,
+                    distance * distance,
+                };
+            }
+
+            Quadric &operator+=(const Quadric &rhs) noexcept{
+                a00 += rhs.a00; a01 += rhs.a01; a02 += rhs.a02;
+                a11 += rhs.a11; a12 += rhs.a12; a22 += rhs.a22;
+                b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2;
+                c += rhs.c;
+                return *this;
+            }
+
+            [[nodiscard]] double evaluate(const glm::dvec3 &p) const noexcept{
+                const double value = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+                                   + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                                   + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z)
+                                   + c;
+                return std::max(value, 0.0); // Cancellation may make it slightly negative.
+            }
+
+            // Solve A p = -b by Cramer's rule. Returns false if A is (nearly) singular, e.g. for a flat neighborhood.
+            [[nodiscard]] bool minimize(glm::dvec3 &p) const noexcept{
+                const double c00 = a11 * a22 - a12 * a12,
+                             c01 = a02 * a12 - a01 * a22,
+                             c02 = a01 * a12 - a02 * a11;
+                const double determinant = a00 * c00 + a01 * c01 + a02 * c02;
+                const double scale = a00 + a11 + a22;
+                if (std::abs(determinant) <= 1e-12 * scale * scale * scale){
+                    return false;
+                }
+
+                const double c11 = a00 * a22 - a02 * a02,
+                             c12 = a01 * a02 - a00 * a12,
+                             c22 = a00 * a11 - a01 * a01;
+                p = -glm::dvec3 {
+                    c00 * b0 + c01 * b1 + c02 * b2,
+                    c01 * b0 + c11 * b1 + c12 * b2,
+                    c02 * b0 + c12 * b1 + c22 * b2,
+                } / determinant;
+                return true;
+            }
+        };
+
+        /*
+         * Vertex-to-triangle incidence in CSR form, rebuilt for each pass (removed triangles are skipped). Rows are sorted
+         * so that the result does not depend on the thread scheduling.
+         */
+        struct Incidence{
+            std::vector<std::uint32_t> row_offsets;
+            std::vector<std::uint32_t> triangle_indices;
+
+            void build(const std::vector<std::array<std::uint32_t, 3>> &triangles, std::size_t num_vertices, unsigned num_threads){
+                row_offsets.assign(num_vertices + 1, 0);
+                parallel_for(std::size_t { 0 }, triangles.size(), [&](std::size_t first, std::size_t last){
+                    for (std::size_t triangle_index = first; triangle_index < last; ++triangle_index){
+                        if (triangles[triangle_index][0] == removed){
+                            continue;
+                        }
+                        for (std::uint32_t vertex_index : triangles[triangle_index]){
+                            std::atomic_ref { row_offsets[vertex_index + 1] }.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }, num_threads);
+                std::inclusive_scan(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+                std::vector<std::uint32_t> cursors { row_offsets.begin(), row_offsets.end() - 1 };
+                triangle_indices.resize(row_offsets.back());
+                parallel_for(std::size_t { 0 }, triangles.size(), [&](std::size_t first, std::size_t last){
+                    for (std::size_t triangle_index = first; triangle_index < last; ++triangle_index){
+                        if (triangles[triangle_index][0] == removed){
+                            continue;
+                        }
+                        for (std::uint32_t vertex_index : triangles[triangle_index]){
+                            const std::uint32_t slot = std::atomic_ref { cursors[vertex_index] }.fetch_add(1, std::memory_order_relaxed);
+                            triangle_indices[slot] = static_cast<std::uint32_t>(triangle_index);
+                        }
+                    }
+                }, num_threads);
+
+                parallel_for(std::size_t { 0 }, num_vertices, [&](std::size_t first, std::size_t last){
+                    for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                        std::sort(triangle_indices.begin() + row_offsets[vertex_index], triangle_indices.begin() + row_offsets[vertex_index + 1]);
+                    }
+                }, num_threads);
+            }
+
+            [[nodiscard]] std::span<const std::uint32_t> row(std::uint32_t vertex_index) const noexcept{
+                return { triangle_indices.data() + row_offsets[vertex_index], triangle_indices.data() + row_offsets[vertex_index + 1] };
+            }
+        };
+
+        struct Collapse{
+            std::uint64_t key; // Upper 32 bits for the cost, lower 32 bits for the half-edge index (tie breaker).
+            std::uint32_t kept, removed;
+            glm::vec3 position;
+            float cost;
+        };
+    }
+
+    /**
+     * Simplify a closed 2-manifold triangle mesh (e.g. from \p Icosphere::generate()) to exactly \p target_triangles
+     * triangles by quadric error metric edge collapses.
+     *
+     * Collapses are done in parallel passes. In each pass, the cost of every edge is evaluated in parallel, and the edges
+     * whose cost is the minimum in the 1-rings of both endpoints are collapsed at once, since they never touch the same
+     * triangles. The cheapest ones are chosen if there are more candidates than needed, so the target is hit exactly.
+     *
+     * Every edge collapse of a closed manifold removes exactly two triangles (and by Euler's formula, a closed genus-0
+     * mesh always has <tt>2V - 4</tt> triangles), therefore the triangle count is always even and \p target_triangles
+     * must be even.
+     *
+     * The error of a collapse is the square root of its quadric error, which bounds the distance from the new vertex to
+     * every plane of the original triangles merged into it. Collapses whose error exceeds \p max_error are never done,
+     * so the decimation stops early if no other collapse is possible (check with \p DecimationResult::reached()).
+     *
+     * @param mesh Closed 2-manifold mesh to be simplified.
+     * @param target_triangles Number of triangles of the result. If it is not less than the current triangle count, the
+     * mesh is returned as is.
+     * @param max_error Upper bound of the collapse error.
+     * @param num_threads Number of threads to be used.
+     * @return Simplified mesh (vertices are compacted and keep their relative order), with its achieved error.
+     * @throw std::invalid_argument If \p target_triangles is odd or less than 4 (tetrahedron).
+     * @throw std::overflow_error If the mesh is too large to be indexed by 32-bit half-edge indices.
+     */
+    template <typename IndexType>
+    DecimationResult<IndexType> simplify(const Mesh<IndexType> &mesh,
+                                         std::size_t target_triangles,
+                                         float max_error = std::numeric_limits<float>::infinity(),
+                                         unsigned num_threads = default_thread_count())
+    {
+        using namespace details;
+
+        if (target_triangles % 2 != 0 || target_triangles < 4){
+            throw std::invalid_argument { "Target triangle count " + std::to_string(target_triangles) + " of a closed mesh must be even and at least 4." };
+        }
+        if (target_triangles >= mesh.triangle_indices.size()){
+            return { mesh };
+        }
+        if (3 * mesh.triangle_indices.size() >= removed || mesh.positions.size() >= removed){
+            throw std::overflow_error { "Mesh with " + std::to_string(mesh.triangle_indices.size()) + " triangles is too large to be decimated." };
+        }
+
+        const std::size_t num_vertices = mesh.positions.size();
+        std::vector<glm::vec3> positions = mesh.positions;
+        std::vector<std::array<std::uint32_t, 3>> triangles(mesh.triangle_indices.size());
+        std::ranges::transform(mesh.triangle_indices, triangles.begin(), [](const auto &indices){
+            return std::array { static_cast<std::uint32_t>(indices[0]), static_cast<std::uint32_t>(indices[1]), static_cast<std::uint32_t>(indices[2]) };
+        });
+
+        Incidence incidence;
+        incidence.build(triangles, num_vertices, num_threads);
+
+        // Initial quadrics are the sum of the planes of the incident triangles.
+        std::vector<Quadric> quadrics(num_vertices);
+        parallel_for(std::size_t { 0 }, num_vertices, [&](std::size_t first, std::size_t last){
+            for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                Quadric quadric {};
+                for (std::uint32_t triangle_index : incidence.row(static_cast<std::uint32_t>(vertex_index))){
+                    const auto [i1, i2, i3] = triangles[triangle_index];
+                    const glm::dvec3 p1 { positions[i1] }, p2 { positions[i2] }, p3 { positions[i3] };
+                    const glm::dvec3 cross = glm::cross(p2 - p1, p3 - p1);
+                    if (const double length = glm::length(cross); length > 0.0){
+                        const glm::dvec3 normal = cross / length;
+                        quadric += Quadric::fromPlane(normal, -glm::dot(normal, p1));
+                    }
+                }
+                quadrics[vertex_index] = quadric;
+            }
+        }, num_threads);
+
+        /*
+         * Evaluate the collapse of the edge (kept, removed) into the best position among the quadric minimizer, the
+         * midpoint and the endpoints. Returns false if the collapse would make the mesh non-manifold (link condition)
+         * or flip/degenerate a triangle.
+         */
+        const auto evaluate = [&](std::uint32_t kept, std::uint32_t removed_vertex, std::vector<std::uint32_t> &kept_neighbors,
+                                  std::vector<std::uint32_t> &removed_neighbors, Collapse &collapse) -> bool {
+            // Link condition: the endpoints must share exactly the two opposite vertices of the edge.
+            const auto gather_neighbors = [&](std::uint32_t vertex_index, std::vector<std::uint32_t> &neighbors){
+                neighbors.clear();
+                for (std::uint32_t triangle_index : incidence.row(vertex_index)){
+                    for (std::uint32_t neighbor : triangles[triangle_index]){
+                        if (neighbor != vertex_index){
+                            neighbors.push_back(neighbor);
+                        }
+                    }
+                }
+                std::ranges::sort(neighbors);
+                neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            };
+            gather_neighbors(kept, kept_neighbors);
+            gather_neighbors(removed_vertex, removed_neighbors);
+            std::size_t num_common_neighbors = 0;
+            for (auto it1 = kept_neighbors.cbegin(), it2 = removed_neighbors.cbegin(); it1 != kept_neighbors.cend() && it2 != removed_neighbors.cend();){
+                if (*it1 < *it2) ++it1;
+                else if (*it2 < *it1) ++it2;
+                else { ++num_common_neighbors; ++it1; ++it2; }
+            }
+            if (num_common_neighbors != 2){
+                return false;
+            }
+
+            Quadric quadric = quadrics[kept];
+            quadric += quadrics[removed_vertex];
+
+            const glm::dvec3 p1 { positions[kept] }, p2 { positions[removed_vertex] };
+            std::array<glm::dvec3, 4> candidates { (p1 + p2) * 0.5, p1, p2, (p1 + p2) * 0.5 };
+            // The minimizer of an ill-conditioned quadric may be far away from the edge, and is not used then.
+            if (glm::dvec3 minimizer; quadric.minimize(minimizer) && glm::length(minimizer - candidates[0]) <= glm::length(p2 - p1)){
+                candidates[3] = minimizer;
+            }
+            double cost = std::numeric_limits<double>::infinity();
+            glm::dvec3 position;
+            for (const glm::dvec3 &candidate : candidates){
+                if (const double candidate_cost = quadric.evaluate(candidate); candidate_cost < cost){
+                    cost = candidate_cost;
+                    position = candidate;
+                }
+            }
+
+            // Triangles remaining after the collapse must not flip or degenerate.
+            for (std::uint32_t vertex_index : { kept, removed_vertex }){
+                for (std::uint32_t triangle_index : incidence.row(vertex_index)){
+                    const auto &indices = triangles[triangle_index];
+                    if (std::ranges::find(indices, kept) != indices.end() && std::ranges::find(indices, removed_vertex) != indices.end()){
+                        continue; // Removed by the collapse.
+                    }
+
+                    std::array<glm::dvec3, 3> before, after;
+                    for (std::size_t corner = 0; corner < 3; ++corner){
+                        before[corner] = after[corner] = glm::dvec3 { positions[indices[corner]] };
+                        if (indices[corner] == vertex_index){
+                            after[corner] = position;
+                        }
+                    }
+                    const glm::dvec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]),
+                                     normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    const double length_product = glm::length(normal_before) * glm::length(normal_after);
+                    if (length_product == 0.0 || glm::dot(normal_before, normal_after) < min_normal_cosine * length_product){
+                        return false;
+                    }
+                }
+            }
+
+            collapse.kept = kept;
+            collapse.removed = removed_vertex;
+            collapse.position = glm::vec3 { position };
+            collapse.cost = static_cast<float>(std::sqrt(cost));
+            return true;
+        };
+
+        /*
+         * Triangles are never moved (removed ones are marked), so that the half-edge indices are stable across passes and
+         * the collapse of an edge is re-evaluated only if a vertex in the 1-ring of its endpoint has been changed.
+         */
+        DecimationResult<IndexType> result;
+        std::size_t num_triangles = triangles.size();
+        std::vector<std::uint64_t> edge_keys(3 * triangles.size(), invalid_key);
+        std::vector<Collapse> edge_collapses(3 * triangles.size());
+        std::vector<std::uint64_t> vertex_min_keys(num_vertices), ring_min_keys(num_vertices);
+        std::vector<std::uint8_t> dirty(num_vertices, 1);
+        while (num_triangles > target_triangles){
+            ++result.num_passes;
+
+            // 1. Evaluate the collapse of each changed edge, at its half-edge (a, b) with a < b.
+            parallel_for(std::size_t { 0 }, triangles.size(), [&](std::size_t first, std::size_t last){
+                std::vector<std::uint32_t> kept_neighbors, removed_neighbors;
+                for (std::size_t triangle_index = first; triangle_index < last; ++triangle_index){
+                    for (std::size_t corner = 0; corner < 3; ++corner){
+                        const std::uint32_t a = triangles[triangle_index][corner], b = triangles[triangle_index][(corner + 1) % 3];
+                        if (a == removed || !(dirty[a] || dirty[b])){
+                            continue;
+                        }
+
+                        const std::size_t half_edge = 3 * triangle_index + corner;
+                        Collapse &collapse = edge_collapses[half_edge];
+                        edge_keys[half_edge] = invalid_key;
+                        if (a < b && evaluate(a, b, kept_neighbors, removed_neighbors, collapse) && collapse.cost <= max_error){
+                            collapse.key = static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(collapse.cost)) << 32 | half_edge;
+                            edge_keys[half_edge] = collapse.key;
+                        }
+                    }
+                }
+            }, num_threads);
+            std::ranges::fill(dirty, 0);
+
+            // 2. Find the minimum key of the edges around each vertex, and then in the 1-ring of each vertex.
+            parallel_for(std::size_t { 0 }, num_vertices, [&](std::size_t first, std::size_t last){
+                for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                    std::uint64_t min_key = invalid_key;
+                    for (std::uint32_t triangle_index : incidence.row(static_cast<std::uint32_t>(vertex_index))){
+                        for (std::size_t corner = 0; corner < 3; ++corner){
+                            if (triangles[triangle_index][corner] == vertex_index || triangles[triangle_index][(corner + 1) % 3] == vertex_index){
+                                min_key = std::min(min_key, edge_keys[3 * triangle_index + corner]);
+                            }
+                        }
+                    }
+                    vertex_min_keys[vertex_index] = min_key;
+                }
+            }, num_threads);
+            parallel_for(std::size_t { 0 }, num_vertices, [&](std::size_t first, std::size_t last){
+                for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                    std::uint64_t min_key = invalid_key;
+                    for (std::uint32_t triangle_index : incidence.row(static_cast<std::uint32_t>(vertex_index))){
+                        for (std::uint32_t neighbor : triangles[triangle_index]){
+                            min_key = std::min(min_key, vertex_min_keys[neighbor]);
+                        }
+                    }
+                    ring_min_keys[vertex_index] = min_key;
+                }
+            }, num_threads);
+
+            /*
+             * 3. An edge is selected if it is the minimum in the 1-rings of both endpoints. If two selected edges touched
+             * the same triangle (or one's endpoint is in the other's 1-ring), each key would be less than the other.
+             */
+            std::vector<Collapse> selected;
+            for (std::size_t half_edge = 0; half_edge < edge_keys.size(); ++half_edge){
+                if (const std::uint64_t key = edge_keys[half_edge]; key != invalid_key){
+                    const Collapse &collapse = edge_collapses[half_edge];
+                    if (ring_min_keys[collapse.kept] == key && ring_min_keys[collapse.removed] == key){
+                        selected.push_back(collapse);
+                    }
+                }
+            }
+            if (selected.empty()){
+                break; // No more collapse within the error bound.
+            }
+
+            const std::size_t num_remaining_collapses = (num_triangles - target_triangles) / 2;
+            if (selected.size() > num_remaining_collapses){
+                std::ranges::nth_element(selected, selected.begin() + num_remaining_collapses, {}, &Collapse::key);
+                selected.resize(num_remaining_collapses);
+            }
+
+            // 4. Collapse the selected edges in parallel. They are independent, so no synchronization is needed.
+            std::vector<float> chunk_errors(std::min<std::size_t>(std::max(num_threads, 1U), selected.size()), 0.f);
+            parallel_for(std::size_t { 0 }, chunk_errors.size(), [&](std::size_t first_chunk, std::size_t last_chunk){
+                for (std::size_t chunk = first_chunk; chunk < last_chunk; ++chunk){
+                    const std::size_t first = selected.size() * chunk / chunk_errors.size(),
+                                      last = selected.size() * (chunk + 1) / chunk_errors.size();
+                    for (std::size_t i = first; i < last; ++i){
+                        const Collapse &collapse = selected[i];
+                        positions[collapse.kept] = collapse.position;
+                        quadrics[collapse.kept] += quadrics[collapse.removed];
+                        for (std::uint32_t triangle_index : incidence.row(collapse.removed)){
+                            auto &indices = triangles[triangle_index];
+                            if (std::ranges::find(indices, collapse.kept) != indices.end()){
+                                indices.fill(removed);
+                                std::fill_n(edge_keys.begin() + 3 * triangle_index, 3, invalid_key);
+                            }
+                            else{
+                                std::ranges::replace(indices, collapse.removed, collapse.kept);
+                            }
+                        }
+                        chunk_errors[chunk] = std::max(chunk_errors[chunk], collapse.cost);
+                    }
+                }
+            }, num_threads);
+            result.error = std::max(result.error, std::ranges::max(chunk_errors));
+            num_triangles -= 2 * selected.size();
+
+            incidence.build(triangles, num_vertices, num_threads);
+
+            // Edges having an endpoint in the new 1-ring of a kept vertex are re-evaluated in the next pass.
+            for (const Collapse &collapse : selected){
+                for (std::uint32_t triangle_index : incidence.row(collapse.kept)){
+                    for (std::uint32_t vertex_index : triangles[triangle_index]){
+                        dirty[vertex_index] = 1;
+                    }
+                }
+            }
+        }
+
+        // Compact the remaining vertices, keeping their relative order.
+        std::vector<std::uint32_t> remap(num_vertices, removed);
+        for (std::size_t vertex_index = 0; vertex_index < num_vertices; ++vertex_index){
+            if (!incidence.row(static_cast<std::uint32_t>(vertex_index)).empty()){
+                remap[vertex_index] = static_cast<std::uint32_t>(result.mesh.positions.size());
+                result.mesh.positions.push_back(positions[vertex_index]);
+            }
+        }
+        result.mesh.triangle_indices.reserve(num_triangles);
+        for (const auto &indices : triangles){
+            if (indices[0] != removed){
+                result.mesh.triangle_indices.push_back({
+                    static_cast<IndexType>(remap[indices[0]]), static_cast<IndexType>(remap[indices[1]]), static_cast<IndexType>(remap[indices[2]]),
+                });
+            }
+        }
+        return result;
+    }
+}
@@ -159,7 +159,7 @@ namespace DirtyPropertyHelper{
     void clean(Function &&function, Props &...props){
         if ((props.isDirty() || ...)){
             std::invoke(DIRTY_PROPERTY_FWD(function), props.value()...);
-            (props.makeDirty(), ...);
+            (props.clean([](const auto&){ }), ...);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Get the default number of worker threads, which is the number of hardware threads (at least 1).
+ */
+inline unsigned default_thread_count() noexcept{
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+/**
+ * Split the index range [\p first, \p last) into contiguous chunks and invoke \p func(chunk_first, chunk_last) for each
+ * chunk in its own thread. The last chunk is processed in the calling thread, and the function returns after all chunks
+ * are processed.
+ *
+ * @param first First index of the range.
+ * @param last One past the last index of the range.
+ * @param func Function to be invoked with the chunk range. It must be safe to invoke concurrently.
+ * @param num_threads Maximum number of chunks (and therefore threads) to be used.
+ *
+ * @code
+ * std::vector<float> values(1'000'000);
+ * parallel_for(std::size_t { 0 }, values.size(), [&](std::size_t first, std::size_t last){
+ *     std::fill(values.begin() + first, values.begin() + last, 1.f);
+ * });
+ * @endcode
+ */
+template <std::integral T, typename Fn> requires std::invocable<Fn&, T, T>
+void parallel_for(T first, T last, Fn &&func, unsigned num_threads = default_thread_count()){
+    if (first >= last){
+        return;
+    }
+
+    const auto count = static_cast<std::size_t>(last - first);
+    const std::size_t num_chunks = std::clamp<std::size_t>(num_threads, 1, count);
+    const auto chunk_first = [&](std::size_t chunk) -> T {
+        return static_cast<T>(first + static_cast<T>(count * chunk / num_chunks));
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(num_chunks - 1);
+        for (std::size_t chunk = 0; chunk < num_chunks - 1; ++chunk){
+            workers.emplace_back([&, chunk]{ std::invoke(func, chunk_first(chunk), chunk_first(chunk + 1)); });
+        }
+        std::invoke(func, chunk_first(num_chunks - 1), last);
+    } // Workers are joined here.
+}
@@ -4,13 +4,26 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
 #include <glm/ext/vector_float3.hpp>
 #include <glm/geometric.hpp>
 
+#include <parallel_for.hpp>
+
 struct Triangle{
     glm::vec3 p1, p2, p3;
 
@@ -45,6 +58,53 @@ struct Mesh{
     }
 };
 
+/**
+ * Vertex adjacency of a mesh in compressed sparse row (CSR) form. The neighbors of the vertex \p i are
+ * <tt>neighbor_indices[row_offsets[i]]</tt>, ..., <tt>neighbor_indices[row_offsets[i + 1] - 1]</tt>, ordered
+ * counter-clockwise around the vertex (seen from outside of the sphere), so that the vertex and two consecutive
+ * neighbors (cyclically) form a triangle of the mesh.
+ *
+ * Row offsets are \p std::size_t, since the number of neighbor entries (6V - 12) exceeds the range of \p IndexType for
+ * large meshes of small index types (e.g. level 6 with \p std::uint16_t).
+ */
+template <typename IndexType>
+struct VertexAdjacency{
+    std::vector<std::size_t> row_offsets;
+    std::vector<IndexType> neighbor_indices;
+
+    [[nodiscard]] constexpr std::size_t numVertices() const noexcept{
+        return row_offsets.size() - 1;
+    }
+
+    [[nodiscard]] constexpr std::size_t valence(std::size_t vertex_index) const noexcept{
+        return row_offsets[vertex_index + 1] - row_offsets[vertex_index];
+    }
+};
+
+/**
+ * Grid point (i, j) of a base face of a geodesic sphere, i + j <= frequency. It is the point
+ * <tt>c0 + i/frequency (c1 - c0) + j/frequency (c2 - c0)</tt> on the flat base face (c0, c1, c2), projected onto the
+ * sphere. Grid points on the base edges have a coordinate in each of the adjacent faces.
+ */
+struct GridCoordinate{
+    std::uint8_t face;
+    std::uint32_t i, j;
+
+    constexpr bool operator==(const GridCoordinate&) const noexcept = default;
+};
+
+/**
+ * Triangle of the grid of a base face, which is upward (i, j), (i + 1, j), (i, j + 1) or downward (i + 1, j),
+ * (i + 1, j + 1), (i, j + 1).
+ */
+struct GridTriangle{
+    std::uint8_t face;
+    std::uint32_t i, j;
+    bool upward;
+
+    constexpr bool operator==(const GridTriangle&) const noexcept = default;
+};
+
 template <typename IndexType>
 class Icosphere{
 private:
@@ -100,12 +160,214 @@ private:
         triangle_index_t { 10, 11,  6 }
     };
 
+    /*
+     * The 30 edges of the icosahedron, in the order of their first appearance in subdivision_0_indices. Each edge is
+     * stored with ascending endpoints and owned by the face where it appears first. face_edges[f][k] is the edge of the
+     * side from the k-th to the (k+1)-th (cyclically) vertex of the face f.
+     */
+    struct BaseEdgeTable{
+        std::array<std::array<IndexType, 2>, 30> edges;
+        std::array<std::uint8_t, 30> owner_faces;
+        std::array<std::array<std::uint8_t, 3>, 20> face_edges;
+    };
+
+    static constexpr BaseEdgeTable base_edge_table = []{
+        BaseEdgeTable table {};
+        std::size_t num_edges = 0;
+        for (std::size_t face_index = 0; face_index < subdivision_0_indices.size(); ++face_index){
+            for (std::size_t side = 0; side < 3; ++side){
+                const auto [from, to] = std::minmax(subdivision_0_indices[face_index][side], subdivision_0_indices[face_index][(side + 1) % 3]);
+                std::size_t edge_index = 0;
+                while (edge_index < num_edges && table.edges[edge_index] != std::array { from, to }){
+                    ++edge_index;
+                }
+                if (edge_index == num_edges){
+                    table.edges[num_edges] = { from, to };
+                    table.owner_faces[num_edges] = static_cast<std::uint8_t>(face_index);
+                    ++num_edges;
+                }
+                table.face_edges[face_index][side] = static_cast<std::uint8_t>(edge_index);
+            }
+        }
+        return table;
+    }();
+
+    static void checkGeodesicFrequency(std::uint32_t frequency){
+        if (frequency == 0){
+            throw std::invalid_argument { "Geodesic sphere frequency must be at least 1." };
+        }
+        if (numGeodesicPositions(frequency) - 1 > std::numeric_limits<IndexType>::max()){
+            throw std::overflow_error {
+                "Geodesic sphere of frequency " + std::to_string(frequency) + " has more positions than the index type can represent."
+            };
+        }
+    }
+
+    /*
+     * The grid point (i, j) of a base face (c0, c1, c2), i + j <= n, is c0 + i/n (c1 - c0) + j/n (c2 - c0) on the flat
+     * face. Grids are stored row by row, where the row i has (n + 1 - i) points.
+     */
+    static constexpr std::size_t geodesicGridIndex(std::size_t n, std::size_t i, std::size_t j) noexcept{
+        return i * (n + 1) - i * (i - 1) / 2 + j;
+    }
+
+    // Grid point of the k-th position (0 <= k <= n) on the side from the side-th to the (side + 1)-th corner.
+    static constexpr std::pair<std::size_t, std::size_t> geodesicSidePoint(std::size_t n, std::size_t side, std::size_t k) noexcept{
+        return side == 0 ? std::pair { k, std::size_t { 0 } } : side == 1 ? std::pair { n - k, k } : std::pair { std::size_t { 0 }, n - k };
+    }
+
+    static void fillGeodesicGrid(std::size_t face_index, std::size_t n, std::vector<glm::vec3> &grid){
+        grid.resize((n + 1) * (n + 2) / 2);
+        const auto grid_point = [&](std::size_t i, std::size_t j) -> glm::vec3& {
+            return grid[geodesicGridIndex(n, i, j)];
+        };
+
+        const triangle_index_t &corners = subdivision_0_indices[face_index];
+        const glm::vec3 &c0 = subdivision_0_positions[corners[0]],
+                        &c1 = subdivision_0_positions[corners[1]],
+                        &c2 = subdivision_0_positions[corners[2]];
+        if (std::has_single_bit(n)){
+            /*
+             * Each grid point of the step h first appears as the midpoint of a side of a triangle of the step 2h, which
+             * lies along one of the directions (1, 0), (0, 1) or (1, -1).
+             */
+            grid_point(0, 0) = c0;
+            grid_point(n, 0) = c1;
+            grid_point(0, n) = c2;
+            for (std::size_t h = n / 2; h >= 1; h /= 2){
+                for (std::size_t i = 0; i <= n; i += h){
+                    for (std::size_t j = 0; i + j <= n; j += h){
+                        const bool i_odd = (i / h) % 2 == 1, j_odd = (j / h) % 2 == 1;
+                        if (!i_odd && !j_odd){
+                            continue;
+                        }
+
+                        const glm::vec3 &p = i_odd ? (j_odd ? grid_point(i - h, j + h) : grid_point(i - h, j)) : grid_point(i, j - h),
+                                        &q = i_odd ? (j_odd ? grid_point(i + h, j - h) : grid_point(i + h, j)) : grid_point(i, j + h);
+                        grid_point(i, j) = glm::normalize((p + q) / 2.f);
+                    }
+                }
+            }
+        }
+        else{
+            const float inv_n = 1.f / static_cast<float>(n);
+            for (std::size_t i = 0; i <= n; ++i){
+                for (std::size_t j = 0; i + j <= n; ++j){
+                    grid_point(i, j) = glm::normalize(c0 + (static_cast<float>(i) * inv_n) * (c1 - c0) + (static_cast<float>(j) * inv_n) * (c2 - c0));
+                }
+            }
+        }
+    }
+
+    static constexpr IndexType geodesicPositionIndex(std::size_t face_index, std::size_t n, std::size_t i, std::size_t j) noexcept{
+        const triangle_index_t &corners = subdivision_0_indices[face_index];
+        const std::size_t edge_positions_first = subdivision_0_positions.size(),
+                          face_positions_first = edge_positions_first + base_edge_table.edges.size() * (n - 1),
+                          num_face_positions = n < 2 ? 0 : (n - 1) * (n - 2) / 2;
+
+        // Index of the k-th position (0 < k < n) on the side from corners[side] to corners[side + 1].
+        const auto edge_position_index = [&](std::size_t side, std::size_t k) -> std::size_t {
+            const std::size_t edge_index = base_edge_table.face_edges[face_index][side];
+            const bool ascending = corners[side] == base_edge_table.edges[edge_index][0];
+            return edge_positions_first + edge_index * (n - 1) + (ascending ? k : n - k) - 1;
+        };
+
+        std::size_t index;
+        if (j == 0){
+            index = i == 0 ? corners[0] : i == n ? corners[1] : edge_position_index(0, i);
+        }
+        else if (i == 0){
+            index = j == n ? corners[2] : edge_position_index(2, n - j);
+        }
+        else if (i + j == n){
+            index = edge_position_index(1, j);
+        }
+        else{
+            // Interior row i (1 <= i <= n - 2) has (n - 1 - i) positions.
+            index = face_positions_first + face_index * num_face_positions + (i - 1) * (n - 1) - i * (i - 1) / 2 + (j - 1);
+        }
+        return static_cast<IndexType>(index);
+    }
+
+    /*
+     * Upward triangles (i, j), (i + 1, j), (i, j + 1) and downward triangles (i + 1, j), (i + 1, j + 1), (i, j + 1) of a
+     * base face, both with the same winding as the base face.
+     */
+    static void fillGeodesicTriangles(std::size_t face_index, std::size_t n, triangle_index_t *triangle_it) noexcept{
+        for (std::size_t i = 0; i < n; ++i){
+            for (std::size_t j = 0; i + j < n; ++j){
+                *triangle_it++ = {
+                    geodesicPositionIndex(face_index, n, i, j), geodesicPositionIndex(face_index, n, i + 1, j), geodesicPositionIndex(face_index, n, i, j + 1),
+                };
+                if (i + j + 1 < n){
+                    *triangle_it++ = {
+                        geodesicPositionIndex(face_index, n, i + 1, j), geodesicPositionIndex(face_index, n, i + 1, j + 1), geodesicPositionIndex(face_index, n, i, j + 1),
+                    };
+                }
+            }
+        }
+    }
+
     static constexpr std::pair<IndexType, IndexType> make_ascending_pair(IndexType idx1, IndexType idx2) noexcept{
         return idx1 < idx2 ? std::make_pair(idx1, idx2) : std::make_pair(idx2, idx1);
     }
 
 public:
-    static mesh_t generate(std::uint8_t level) noexcept{
+    /**
+     * @brief Get the number of positions of the icosphere with the given subdivision level, which is 10 * 4^level + 2.
+     * @note The result overflows for level > 30.
+     */
+    static constexpr std::size_t numPositions(std::uint8_t level) noexcept{
+        return 10 * (std::size_t { 1 } << (2 * level)) + 2;
+    }
+
+    /**
+     * @brief Get the number of triangles of the icosphere with the given subdivision level, which is 20 * 4^level.
+     * @note The result overflows for level > 30.
+     */
+    static constexpr std::size_t numTriangles(std::uint8_t level) noexcept{
+        return 20 * (std::size_t { 1 } << (2 * level));
+    }
+
+    /**
+     * @brief Get the number of positions of the geodesic sphere with the given frequency, which is 10 * frequency^2 + 2.
+     * @note The result overflows for frequency >= 2^30.
+     */
+    static constexpr std::size_t numGeodesicPositions(std::uint32_t frequency) noexcept{
+        return 10 * static_cast<std::size_t>(frequency) * frequency + 2;
+    }
+
+    /**
+     * @brief Get the number of triangles of the geodesic sphere with the given frequency, which is 20 * frequency^2.
+     * @note The result overflows for frequency >= 2^30.
+     */
+    static constexpr std::size_t numGeodesicTriangles(std::uint32_t frequency) noexcept{
+        return 20 * static_cast<std::size_t>(frequency) * frequency;
+    }
+
+    /**
+     * @brief Check if all position indices of the icosphere with the given subdivision level can be represented by
+     * \p IndexType.
+     *
+     * The largest index is 10 * 4^level + 1, which needs exactly (2 * level + 4) bits.
+     */
+    static constexpr bool isRepresentable(std::uint8_t level) noexcept{
+        return 2 * level + 4 <= std::numeric_limits<IndexType>::digits;
+    }
+
+    /**
+     * Generate the icosphere mesh with the given subdivision level.
+     * @param level Subdivision level.
+     * @return Generated mesh.
+     * @throw std::overflow_error If the position indices cannot be represented by \p IndexType.
+     */
+    static mesh_t generate(std::uint8_t level){
+        if (!isRepresentable(level)){
+            throw std::overflow_error {
+                "Icosphere of level " + std::to_string(level) + " has more positions than the index type can represent."
+            };
+        }
+
         if (level == 0){
             return { .positions = { subdivision_0_positions.cbegin(), subdivision_0_positions.cend() },
                      .triangle_indices = { subdivision_0_indices.cbegin(), subdivision_0_indices.cend() } };
@@ -169,4 +431,522 @@ public:
 
         return { .positions = std::move(new_positions), .triangle_indices = std::move(new_triangle_indices) };
     }
+
+    /**
+     * Generate the class I geodesic sphere with the given frequency, whose base faces are divided into frequency x
+     * frequency triangular grids. Unlike \p generate(), any frequency is allowed (\p generate() of level L is the
+     * frequency 2^L), so the triangle count 20 * frequency^2 can be chosen more finely.
+     *
+     * The number of positions on each base edge and inside each base face is known in advance, therefore every position
+     * has a closed-form index, and the faces are generated in parallel without any hash map. Positions are laid out as:
+     * 1. 12 icosahedron vertices,
+     * 2. (frequency - 1) positions of each of 30 base edges (in the order of \p base_edge_table), from the lower
+     *    endpoint index to the higher, and
+     * 3. (frequency - 1)(frequency - 2)/2 interior positions of each of 20 base faces, row by row.
+     * Triangles of each base face are contiguous and in the order of \p subdivision_0_indices.
+     *
+     * If the frequency is a power of two, positions are made by normalized midpoint bisection as \p generate() does,
+     * and the result is the same as \p generate() up to the permutation of the positions and triangles. Otherwise, the
+     * grid points of the flat base face are projected onto the sphere.
+     *
+     * @param frequency Number of divisions of each base edge (at least 1).
+     * @param num_threads Number of threads to be used (at most 20, one base face per thread).
+     * @return Generated mesh.
+     * @throw std::invalid_argument If \p frequency is 0.
+     * @throw std::overflow_error If the position indices cannot be represented by \p IndexType.
+     */
+    static mesh_t generateGeodesic(std::uint32_t frequency, unsigned num_threads = default_thread_count()){
+        checkGeodesicFrequency(frequency);
+
+        const std::size_t n = frequency;
+        mesh_t mesh;
+        mesh.positions.resize(numGeodesicPositions(frequency));
+        mesh.triangle_indices.resize(numGeodesicTriangles(frequency));
+        std::ranges::copy(subdivision_0_positions, mesh.positions.begin());
+
+        parallel_for(std::size_t { 0 }, subdivision_0_indices.size(), [&](std::size_t first_face, std::size_t last_face){
+            std::vector<glm::vec3> grid;
+            for (std::size_t face_index = first_face; face_index < last_face; ++face_index){
+                fillGeodesicGrid(face_index, n, grid);
+
+                // Each face writes its interior positions and the positions of the edges it owns.
+                for (std::size_t side = 0; side < 3; ++side){
+                    if (base_edge_table.owner_faces[base_edge_table.face_edges[face_index][side]] != face_index){
+                        continue;
+                    }
+                    for (std::size_t k = 1; k < n; ++k){
+                        const auto [i, j] = geodesicSidePoint(n, side, k);
+                        mesh.positions[geodesicPositionIndex(face_index, n, i, j)] = grid[geodesicGridIndex(n, i, j)];
+                    }
+                }
+                for (std::size_t i = 1; i + 1 < n; ++i){
+                    for (std::size_t j = 1; i + j < n; ++j){
+                        mesh.positions[geodesicPositionIndex(face_index, n, i, j)] = grid[geodesicGridIndex(n, i, j)];
+                    }
+                }
+
+                fillGeodesicTriangles(face_index, n, mesh.triangle_indices.data() + face_index * n * n);
+            }
+        }, num_threads);
+
+        return mesh;
+    }
+
+    /**
+     * Generate the same geodesic sphere as \p generateGeodesic(), but pass the positions and triangles to the sinks in
+     * blocks (in the index order) instead of storing them, so that it can be written while generated. At most one base
+     * face (1/20 of the mesh) is kept in memory at a time. All positions are passed before the first triangle.
+     *
+     * @param frequency Number of divisions of each base edge (at least 1).
+     * @param position_sink Function invoked with each block of the positions, as <tt>std::span<const glm::vec3></tt>.
+     * @param triangle_sink Function invoked with each block of the triangles, as <tt>std::span<const triangle_index_t></tt>.
+     * @throw std::invalid_argument If \p frequency is 0.
+     * @throw std::overflow_error If the position indices cannot be represented by \p IndexType.
+     *
+     * @code
+     * Icosphere<std::uint32_t>::streamGeodesic(frequency,
+     *     [&](std::span<const glm::vec3> positions){ writer.writePositions(positions); },
+     *     [&](std::span<const std::array<std::uint32_t, 3>> triangles){ writer.writeTriangles(triangles); });
+     * @endcode
+     */
+    template <typename PositionSink, typename TriangleSink>
+        requires std::invocable<PositionSink&, std::span<const glm::vec3>> && std::invocable<TriangleSink&, std::span<const triangle_index_t>>
+    static void streamGeodesic(std::uint32_t frequency, PositionSink &&position_sink, TriangleSink &&triangle_sink){
+        checkGeodesicFrequency(frequency);
+
+        const std::size_t n = frequency;
+        std::vector<glm::vec3> grid, block;
+        position_sink(std::span<const glm::vec3> { subdivision_0_positions });
+
+        // Edges are numbered by their first appearance, so visiting the owner faces in order emits them in order.
+        for (std::size_t face_index = 0; face_index < subdivision_0_indices.size(); ++face_index){
+            block.clear();
+            for (std::size_t side = 0; side < 3; ++side){
+                const std::size_t edge_index = base_edge_table.face_edges[face_index][side];
+                if (base_edge_table.owner_faces[edge_index] != face_index){
+                    continue;
+                }
+                if (block.empty()){
+                    fillGeodesicGrid(face_index, n, grid);
+                }
+                const bool ascending = subdivision_0_indices[face_index][side] == base_edge_table.edges[edge_index][0];
+                for (std::size_t t = 1; t < n; ++t){
+                    const auto [i, j] = geodesicSidePoint(n, side, ascending ? t : n - t);
+                    block.push_back(grid[geodesicGridIndex(n, i, j)]);
+                }
+            }
+            if (!block.empty()){
+                position_sink(std::span<const glm::vec3> { block });
+            }
+        }
+
+        for (std::size_t face_index = 0; face_index < subdivision_0_indices.size() && n > 2; ++face_index){
+            fillGeodesicGrid(face_index, n, grid);
+            block.clear();
+            for (std::size_t i = 1; i + 1 < n; ++i){
+                block.insert(block.end(), grid.begin() + geodesicGridIndex(n, i, 1), grid.begin() + geodesicGridIndex(n, i, n - i));
+            }
+            position_sink(std::span<const glm::vec3> { block });
+        }
+
+        std::vector<triangle_index_t> triangles(n * n);
+        for (std::size_t face_index = 0; face_index < subdivision_0_indices.size(); ++face_index){
+            fillGeodesicTriangles(face_index, n, triangles.data());
+            triangle_sink(std::span<const triangle_index_t> { triangles });
+        }
+    }
+
+    /*
+     * Random access to the icosphere of a subdivision level without generating it. Triangles are addressed by their
+     * index in generate(): the triangle t of level L is divided into the triangles 4t, ..., 4t + 3 of level L + 1, so the
+     * index is (base face) * 4^L + (base-4 digits of the path through the subdivision tree). Vertices are addressed by
+     * their grid coordinate in the base face (frequency 2^L), or by their index in generateGeodesic(2^L).
+     *
+     * Positions are computed by the same normalized midpoint bisection along the path, therefore they are bitwise
+     * identical to generate(). Each query takes O(level) time.
+     */
+
+    /**
+     * @brief Get the grid coordinates of the vertices of a triangle, in the same order as in \p generate().
+     * @param level Subdivision level (at most 29).
+     * @param triangle_index Index of the triangle in \p generate().
+     */
+    static constexpr std::array<GridCoordinate, 3> triangleGrid(std::uint8_t level, std::size_t triangle_index) noexcept{
+        assert(triangle_index < numTriangles(level));
+
+        using point_t = std::array<std::uint32_t, 2>;
+        const auto midpoint = [](const point_t &a, const point_t &b) noexcept -> point_t {
+            return { (a[0] + b[0]) / 2, (a[1] + b[1]) / 2 };
+        };
+
+        const std::uint32_t n = std::uint32_t { 1 } << level;
+        point_t a { 0, 0 }, b { n, 0 }, c { 0, n };
+        for (int shift = 2 * (level - 1); shift >= 0; shift -= 2){
+            const point_t m_ab = midpoint(a, b), m_bc = midpoint(b, c), m_ca = midpoint(c, a);
+            switch ((triangle_index >> shift) & 3){
+                case 0: b = m_ab; c = m_ca; break;
+                case 1: a = m_ab; c = m_bc; break;
+                case 2: a = m_ca; b = m_bc; break;
+                default: a = m_ab; b = m_bc; c = m_ca; break;
+            }
+        }
+
+        const auto face = static_cast<std::uint8_t>(triangle_index >> (2 * level));
+        return { GridCoordinate { face, a[0], a[1] }, GridCoordinate { face, b[0], b[1] }, GridCoordinate { face, c[0], c[1] } };
+    }
+
+    /**
+     * @brief Get the grid triangle of the triangle with the given index.
+     * @param level Subdivision level (at most 29).
+     * @param triangle_index Index of the triangle in \p generate().
+     */
+    static constexpr GridTriangle toGridTriangle(std::uint8_t level, std::size_t triangle_index) noexcept{
+        const auto [p1, p2, p3] = triangleGrid(level, triangle_index);
+        // The sum of i + j of the vertices is 3(i + j) + 2 for upward, and 3(i + j) + 4 for downward triangle.
+        const std::uint32_t i = std::min({ p1.i, p2.i, p3.i }), j = std::min({ p1.j, p2.j, p3.j });
+        return { p1.face, i, j, p1.i + p1.j + p2.i + p2.j + p3.i + p3.j == 3 * (i + j) + 2 };
+    }
+
+    /**
+     * @brief Get the index (in \p generate()) of the grid triangle, by descending the subdivision tree to the child
+     * containing its centroid.
+     * @param level Subdivision level (at most 29).
+     * @param triangle Grid triangle of the frequency 2^level.
+     */
+    static constexpr std::size_t triangleIndex(std::uint8_t level, const GridTriangle &triangle) noexcept{
+        // Coordinates are scaled by 3, so that the centroid is an integer point.
+        using point_t = std::array<std::int64_t, 2>;
+        const auto midpoint = [](const point_t &a, const point_t &b) noexcept -> point_t {
+            return { (a[0] + b[0]) / 2, (a[1] + b[1]) / 2 };
+        };
+        // Positive if p is on the left of the directed line a -> b.
+        const auto edge = [](const point_t &a, const point_t &b, const point_t &p) noexcept {
+            return (b[0] - a[0]) * (p[1] - a[1]) - (b[1] - a[1]) * (p[0] - a[0]);
+        };
+
+        const std::int64_t n = std::int64_t { 3 } << level;
+        const std::int64_t offset = triangle.upward ? 1 : 2;
+        const point_t centroid { 3 * static_cast<std::int64_t>(triangle.i) + offset, 3 * static_cast<std::int64_t>(triangle.j) + offset };
+
+        std::size_t triangle_index = triangle.face;
+        point_t a { 0, 0 }, b { n, 0 }, c { 0, n };
+        for (std::uint8_t depth = 0; depth < level; ++depth){
+            const point_t m_ab = midpoint(a, b), m_bc = midpoint(b, c), m_ca = midpoint(c, a);
+            std::size_t digit;
+            if (edge(m_ab, m_ca, centroid) > 0){
+                digit = 0; b = m_ab; c = m_ca;
+            }
+            else if (edge(m_bc, m_ab, centroid) > 0){
+                digit = 1; a = m_ab; c = m_bc;
+            }
+            else if (edge(m_ca, m_bc, centroid) > 0){
+                digit = 2; a = m_ca; b = m_bc;
+            }
+            else{
+                digit = 3; a = m_ab; b = m_bc; c = m_ca;
+            }
+            triangle_index = 4 * triangle_index + digit;
+        }
+        return triangle_index;
+    }
+
+    /**
+     * @brief Get the vertex positions of a triangle, bitwise identical to those of \p generate().
+     * @param level Subdivision level (at most 29).
+     * @param triangle_index Index of the triangle in \p generate().
+     */
+    static Triangle triangle(std::uint8_t level, std::size_t triangle_index) noexcept{
+        assert(triangle_index < numTriangles(level));
+
+        const triangle_index_t &corners = subdivision_0_indices[triangle_index >> (2 * level)];
+        glm::vec3 a = subdivision_0_positions[corners[0]], b = subdivision_0_positions[corners[1]], c = subdivision_0_positions[corners[2]];
+        for (int shift = 2 * (level - 1); shift >= 0; shift -= 2){
+            const glm::vec3 m_ab = glm::normalize((a + b) / 2.f), m_bc = glm::normalize((b + c) / 2.f), m_ca = glm::normalize((c + a) / 2.f);
+            switch ((triangle_index >> shift) & 3){
+                case 0: b = m_ab; c = m_ca; break;
+                case 1: a = m_ab; c = m_bc; break;
+                case 2: a = m_ca; b = m_bc; break;
+                default: a = m_ab; b = m_bc; c = m_ca; break;
+            }
+        }
+        return { a, b, c };
+    }
+
+    /**
+     * @brief Get the position of the vertex, bitwise identical to that of \p generate(), by descending the subdivision
+     * tree until the vertex becomes a corner or a midpoint.
+     * @param level Subdivision level (at most 29).
+     * @param coordinate Grid coordinate of the frequency 2^level, i.e. <tt>i + j <= 2^level</tt>.
+     */
+    static glm::vec3 vertexPosition(std::uint8_t level, const GridCoordinate &coordinate) noexcept{
+        using point_t = std::array<std::int64_t, 2>;
+        const auto midpoint = [](const point_t &a, const point_t &b) noexcept -> point_t {
+            return { (a[0] + b[0]) / 2, (a[1] + b[1]) / 2 };
+        };
+        const auto edge = [](const point_t &a, const point_t &b, const point_t &p) noexcept {
+            return (b[0] - a[0]) * (p[1] - a[1]) - (b[1] - a[1]) * (p[0] - a[0]);
+        };
+
+        const std::int64_t n = std::int64_t { 1 } << level;
+        assert(coordinate.face < subdivision_0_indices.size() && std::int64_t { coordinate.i } + coordinate.j <= n);
+
+        const point_t p { coordinate.i, coordinate.j };
+        const triangle_index_t &corners = subdivision_0_indices[coordinate.face];
+        point_t a { 0, 0 }, b { n, 0 }, c { 0, n };
+        glm::vec3 pa = subdivision_0_positions[corners[0]], pb = subdivision_0_positions[corners[1]], pc = subdivision_0_positions[corners[2]];
+        // Each step halves the triangle, so a valid coordinate becomes a corner after at most level steps.
+        for (std::uint8_t depth = 0; depth < level; ++depth){
+            if (p == a) return pa;
+            if (p == b) return pb;
+            if (p == c) return pc;
+
+            const point_t m_ab = midpoint(a, b), m_bc = midpoint(b, c), m_ca = midpoint(c, a);
+            const glm::vec3 pm_ab = glm::normalize((pa + pb) / 2.f), pm_bc = glm::normalize((pb + pc) / 2.f), pm_ca = glm::normalize((pc + pa) / 2.f);
+            if (edge(m_ab, m_ca, p) >= 0){
+                b = m_ab; c = m_ca; pb = pm_ab; pc = pm_ca;
+            }
+            else if (edge(m_bc, m_ab, p) >= 0){
+                a = m_ab; c = m_bc; pa = pm_ab; pc = pm_bc;
+            }
+            else if (edge(m_ca, m_bc, p) >= 0){
+                a = m_ca; b = m_bc; pa = pm_ca; pb = pm_bc;
+            }
+            else{
+                a = m_ab; b = m_bc; c = m_ca; pa = pm_ab; pb = pm_bc; pc = pm_ca;
+            }
+        }
+
+        if (p == a) return pa;
+        if (p == b) return pb;
+        assert(p == c);
+        return pc;
+    }
+
+    /**
+     * @brief Get the index of the vertex in \p generateGeodesic() of the frequency 2^level, whose positions are the
+     * same as \p generate() up to permutation.
+     */
+    static constexpr IndexType vertexIndex(std::uint8_t level, const GridCoordinate &coordinate) noexcept{
+        assert(isRepresentable(level));
+        return geodesicPositionIndex(coordinate.face, std::size_t { 1 } << level, coordinate.i, coordinate.j);
+    }
+
+    /**
+     * @brief Get a grid coordinate of the vertex with the given index in \p generateGeodesic() of the frequency 2^level.
+     * Vertices on the base edges have multiple coordinates, and the one in the face that owns them is returned.
+     */
+    static GridCoordinate vertexCoordinate(std::uint8_t level, std::size_t vertex_index) noexcept{
+        assert(vertex_index < numPositions(level));
+
+        const std::size_t n = std::size_t { 1 } << level;
+        const auto side_coordinate = [&](std::size_t face_index, std::size_t side, std::size_t k) -> GridCoordinate {
+            const auto [i, j] = geodesicSidePoint(n, side, k);
+            return { static_cast<std::uint8_t>(face_index), static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j) };
+        };
+
+        if (vertex_index < subdivision_0_positions.size()){
+            for (std::size_t face_index = 0; ; ++face_index){
+                if (const auto it = std::ranges::find(subdivision_0_indices[face_index], vertex_index); it != subdivision_0_indices[face_index].end()){
+                    return side_coordinate(face_index, it - subdivision_0_indices[face_index].begin(), 0);
+                }
+            }
+        }
+
+        const std::size_t edge_local_index = vertex_index - subdivision_0_positions.size();
+        if (edge_local_index < base_edge_table.edges.size() * (n - 1)){
+            const std::size_t edge_index = edge_local_index / (n - 1), t = edge_local_index % (n - 1) + 1;
+            const std::size_t face_index = base_edge_table.owner_faces[edge_index];
+            const std::size_t side = std::ranges::find(base_edge_table.face_edges[face_index], edge_index) - base_edge_table.face_edges[face_index].begin();
+            const bool ascending = subdivision_0_indices[face_index][side] == base_edge_table.edges[edge_index][0];
+            return side_coordinate(face_index, side, ascending ? t : n - t);
+        }
+
+        /*
+         * Interior positions of a face are stored row by row, where the row i has m = n - 1 - i positions. Counted from
+         * the end of the face, the rows with fewer than m positions have m(m - 1)/2 positions in total.
+         */
+        const std::size_t num_face_positions = (n - 1) * (n - 2) / 2;
+        const std::size_t face_local_index = edge_local_index - base_edge_table.edges.size() * (n - 1);
+        const std::size_t face_index = face_local_index / num_face_positions,
+                          from_end = num_face_positions - 1 - face_local_index % num_face_positions;
+        std::size_t m = static_cast<std::size_t>((1.0 + std::sqrt(8.0 * static_cast<double>(from_end) + 1.0)) / 2.0);
+        while (m * (m - 1) / 2 > from_end) --m;
+        while (m * (m + 1) / 2 <= from_end) ++m;
+        const std::size_t i = n - 1 - m, j = m - (from_end - m * (m - 1) / 2);
+        return { static_cast<std::uint8_t>(face_index), static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j) };
+    }
+
+    /**
+     * @brief Get the indices of the three triangles sharing the edges (v1, v2), (v2, v3) and (v3, v1) of the triangle.
+     * Neighbors across a base edge are found in the adjacent base face.
+     * @param level Subdivision level (at most 29).
+     * @param triangle_index Index of the triangle in \p generate().
+     */
+    static constexpr std::array<std::size_t, 3> triangleNeighbors(std::uint8_t level, std::size_t triangle_index) noexcept{
+        const std::uint32_t n = std::uint32_t { 1 } << level;
+        const std::array<GridCoordinate, 3> vertices = triangleGrid(level, triangle_index);
+        const std::uint8_t face_index = vertices[0].face;
+
+        std::array<std::size_t, 3> neighbors;
+        for (std::size_t k = 0; k < 3; ++k){
+            const GridCoordinate &p = vertices[k], &q = vertices[(k + 1) % 3], &opposite = vertices[(k + 2) % 3];
+
+            // In the same face, the neighbor is the reflection of the opposite vertex across the edge.
+            const std::int64_t ri = std::int64_t { p.i } + q.i - opposite.i, rj = std::int64_t { p.j } + q.j - opposite.j;
+            if (ri >= 0 && rj >= 0 && ri + rj <= n){
+                const std::uint32_t i = std::min({ p.i, q.i, static_cast<std::uint32_t>(ri) }),
+                                    j = std::min({ p.j, q.j, static_cast<std::uint32_t>(rj) });
+                neighbors[k] = triangleIndex(level, { face_index, i, j, p.i + p.j + q.i + q.j + ri + rj == 3 * (i + j) + 2 });
+                continue;
+            }
+
+            // Otherwise, the edge is on the side (of the base face) containing both p and q.
+            const std::size_t side = p.j == 0 && q.j == 0 ? 0 : p.i + p.j == n && q.i + q.j == n ? 1 : 2;
+            const std::size_t edge_index = base_edge_table.face_edges[face_index][side];
+            std::size_t adjacent_face = 0, adjacent_side = 0;
+            for (std::size_t f = 0; f < subdivision_0_indices.size(); ++f){
+                for (std::size_t s = 0; s < 3; ++s){
+                    if (f != face_index && base_edge_table.face_edges[f][s] == edge_index){
+                        adjacent_face = f;
+                        adjacent_side = s;
+                    }
+                }
+            }
+
+            // Map the position on the side to the adjacent face via the distance from the lower endpoint of the edge.
+            const auto distance_from_lower = [&](std::size_t f, std::size_t s, std::size_t k_from_corner){
+                return subdivision_0_indices[f][s] == base_edge_table.edges[edge_index][0] ? k_from_corner : n - k_from_corner;
+            };
+            const auto side_k = [&](const GridCoordinate &v) -> std::size_t {
+                return side == 0 ? v.i : side == 1 ? v.j : n - v.j;
+            };
+            const auto to_adjacent = [&](const GridCoordinate &v){
+                const std::size_t t = distance_from_lower(face_index, side, side_k(v));
+                return geodesicSidePoint(n, adjacent_side, distance_from_lower(adjacent_face, adjacent_side, t));
+            };
+            const auto [pi, pj] = to_adjacent(p);
+            const auto [qi, qj] = to_adjacent(q);
+            neighbors[k] = triangleIndex(level, {
+                static_cast<std::uint8_t>(adjacent_face), static_cast<std::uint32_t>(std::min(pi, qi)), static_cast<std::uint32_t>(std::min(pj, qj)), true,
+            });
+        }
+        return neighbors;
+    }
+
+    /**
+     * @brief Get the index of the triangle hit by the ray from the center of the sphere toward \p direction, by
+     * descending the subdivision tree with the planes through the center and the triangle edges.
+     * @param level Subdivision level (at most 29).
+     * @param direction Direction from the center (need not be normalized).
+     */
+    static std::size_t locate(std::uint8_t level, const glm::vec3 &direction) noexcept{
+        // Inside of the counter-clockwise (seen from outside) spherical triangle is on the left of each directed edge.
+        const auto inside = [&](const glm::vec3 &a, const glm::vec3 &b) noexcept {
+            return glm::dot(direction, glm::cross(a, b)) >= 0.f;
+        };
+
+        std::size_t triangle_index = 0;
+        for (std::size_t face_index = 0; face_index < subdivision_0_indices.size(); ++face_index){
+            const auto [i1, i2, i3] = subdivision_0_indices[face_index];
+            const glm::vec3 &a = subdivision_0_positions[i1], &b = subdivision_0_positions[i2], &c = subdivision_0_positions[i3];
+            if (inside(a, b) && inside(b, c) && inside(c, a)){
+                triangle_index = face_index;
+                break;
+            }
+        }
+
+        const triangle_index_t &corners = subdivision_0_indices[triangle_index];
+        glm::vec3 a = subdivision_0_positions[corners[0]], b = subdivision_0_positions[corners[1]], c = subdivision_0_positions[corners[2]];
+        for (std::uint8_t depth = 0; depth < level; ++depth){
+            const glm::vec3 m_ab = glm::normalize((a + b) / 2.f), m_bc = glm::normalize((b + c) / 2.f), m_ca = glm::normalize((c + a) / 2.f);
+            std::size_t digit;
+            if (inside(m_ab, m_ca)){
+                digit = 0; b = m_ab; c = m_ca;
+            }
+            else if (inside(m_bc, m_ab)){
+                digit = 1; a = m_ab; c = m_bc;
+            }
+            else if (inside(m_ca, m_bc)){
+                digit = 2; a = m_ca; b = m_bc;
+            }
+            else{
+                digit = 3; a = m_ab; b = m_bc; c = m_ca;
+            }
+            triangle_index = 4 * triangle_index + digit;
+        }
+        return triangle_index;
+    }
+
+    /**
+     * Lazily enumerate the triangles of a patch, which are the descendants (of the subdivision level \p level) of the
+     * triangle \p patch_index of the coarser level \p patch_level. They are contiguous in \p generate().
+     *
+     * @param level Subdivision level of the triangles (at most 29).
+     * @param patch_level Subdivision level of the patch (at most \p level).
+     * @param patch_index Index of the patch triangle in \p generate() of \p patch_level (e.g. from \p locate()).
+     * @return Random access range of \p Triangle, which are computed when accessed.
+     *
+     * @code
+     * // 4^6 triangles of level 10 around the view direction.
+     * for (const Triangle &triangle : Icosphere<std::uint32_t>::patch(10, 4, Icosphere<std::uint32_t>::locate(4, view_dir))){
+     *     // ...
+     * }
+     * @endcode
+     */
+    static auto patch(std::uint8_t level, std::uint8_t patch_level, std::size_t patch_index) noexcept{
+        assert(patch_level <= level);
+        const std::size_t size = std::size_t { 1 } << (2 * (level - patch_level));
+        return std::views::iota(patch_index * size, (patch_index + 1) * size)
+             | std::views::transform([level](std::size_t triangle_index){ return triangle(level, triangle_index); });
+    }
+
+    /**
+     * Build the CSR vertex adjacency of an icosphere generated by \p generate().
+     *
+     * The positions of the previous subdivision level are always kept at the front of the positions, therefore the
+     * first 12 vertices are the icosahedron vertices with valence 5, and all the other vertices have valence 6. Row
+     * offsets are known in advance, and each triangle directly fills its slots without any hash map.
+     *
+     * @param mesh Mesh generated by \p generate().
+     * @return Vertex adjacency whose rows are ordered counter-clockwise.
+     */
+    static VertexAdjacency<IndexType> generateAdjacency(const mesh_t &mesh){
+        const std::size_t num_positions = mesh.positions.size();
+        assert(num_positions >= subdivision_0_positions.size());
+        assert(3 * mesh.triangle_indices.size() == 6 * num_positions - 12 /* 2 * (the number of edges) */);
+
+        VertexAdjacency<IndexType> adjacency;
+        adjacency.row_offsets.resize(num_positions + 1);
+        for (std::size_t vertex_index = 0; vertex_index <= num_positions; ++vertex_index){
+            adjacency.row_offsets[vertex_index] = 6 * vertex_index - std::min(vertex_index, subdivision_0_positions.size());
+        }
+
+        /*
+         * For each triangle (v, a, b) incident to the vertex v, a comes right before b in the counter-clockwise order
+         * around v. These (a, b) pairs are collected in the row of v, and then chained into a single cycle.
+         */
+        std::vector<std::pair<IndexType, IndexType>> ordered_pairs(adjacency.row_offsets.back());
+        std::vector<std::size_t> cursors { adjacency.row_offsets.cbegin(), adjacency.row_offsets.cend() - 1 };
+        for (const auto [i1, i2, i3] : mesh.triangle_indices){
+            ordered_pairs[cursors[i1]++] = { i2, i3 };
+            ordered_pairs[cursors[i2]++] = { i3, i1 };
+            ordered_pairs[cursors[i3]++] = { i1, i2 };
+        }
+
+        adjacency.neighbor_indices.resize(ordered_pairs.size());
+        for (std::size_t vertex_index = 0; vertex_index < num_positions; ++vertex_index){
+            const auto row_begin = ordered_pairs.begin() + adjacency.row_offsets[vertex_index],
+                       row_end = ordered_pairs.begin() + adjacency.row_offsets[vertex_index + 1];
+            assert(cursors[vertex_index] == adjacency.row_offsets[vertex_index + 1]);
+
+            IndexType current = row_begin->first;
+            for (std::size_t slot = adjacency.row_offsets[vertex_index]; slot < adjacency.row_offsets[vertex_index + 1]; ++slot){
+                adjacency.neighbor_indices[slot] = current;
+                current = std::ranges::find(row_begin, row_end, current, &std::pair<IndexType, IndexType>::first)->second;
+            }
+            assert(current == row_begin->first); // The ring must be closed.
+        }
+
+        return adjacency;
+    }
 };
\ No newline at end of file
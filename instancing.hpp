@@ -0,0 +1,194 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/geometric.hpp>
+
+#include <parallel_for.hpp>
+
+/**
+ * Per-instance data of a sphere, which is also the layout of the per-instance vertex attribute (<tt>vec4</tt>, xyz for
+ * the center and w for the radius).
+ */
+struct SphereInstance{
+    glm::vec3 center;
+    float radius;
+};
+static_assert(sizeof(SphereInstance) == sizeof(glm::vec4));
+
+/**
+ * View frustum represented by six planes whose normals point inside.
+ */
+struct Frustum{
+    std::array<glm::vec4, 6> planes; // (normal, distance), normalized.
+
+    /**
+     * Extract the frustum planes from the combined projection-view matrix (Gribb-Hartmann method).
+     * @param projection_view Projection matrix multiplied by view matrix.
+     * @return Frustum in world space.
+     */
+    static Frustum fromMatrix(const glm::mat4 &projection_view) noexcept{
+        const auto row = [&](int i) -> glm::vec4 {
+            return { projection_view[0][i], projection_view[1][i], projection_view[2][i], projection_view[3][i] };
+        };
+
+        Frustum frustum {
+            row(3) + row(0), row(3) - row(0), // left, right
+            row(3) + row(1), row(3) - row(1), // bottom, top
+            row(3) + row(2), row(3) - row(2), // near, far
+        };
+        for (glm::vec4 &plane : frustum.planes){
+            plane /= glm::length(glm::vec3 { plane.x, plane.y, plane.z });
+        }
+        return frustum;
+    }
+
+    [[nodiscard]] bool intersects(const glm::vec3 &center, float radius) const noexcept{
+        return std::ranges::all_of(planes, [&](const glm::vec4 &plane){
+            return plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w >= -radius;
+        });
+    }
+};
+
+/**
+ * Instances of the same subdivision level, which can be drawn with a single instanced draw call. They are in
+ * <tt>[first_instance, first_instance + instance_count)</tt> of the packed instance buffer.
+ */
+struct InstanceBatch{
+    std::uint8_t level;
+    std::uint32_t first_instance;
+    std::uint32_t instance_count;
+};
+
+/**
+ * CPU stage of the instanced rendering. For each frame, it
+ * 1. culls the instances whose bounding sphere is outside of the view frustum,
+ * 2. selects the subdivision level of each visible instance by its distance to the camera, and
+ * 3. packs the visible instances into a buffer, grouped by subdivision level (from the finest, since they are nearer) and
+ *    sorted front-to-back in each group.
+ * All steps are run in parallel, and \p instances and \p batches can be uploaded/drawn directly.
+ *
+ * @code
+ * InstanceCuller culler { .max_level = 4 };
+ * culler.cull(spheres, projection_view, camera_position);
+ * glBufferData(GL_ARRAY_BUFFER, culler.instances.size() * sizeof(SphereInstance), culler.instances.data(), GL_STREAM_DRAW);
+ * for (const InstanceBatch &batch : culler.batches){
+ *     // Draw batch.instance_count instances of the icosphere of batch.level, starting from batch.first_instance.
+ * }
+ * @endcode
+ */
+struct InstanceCuller{
+    std::uint8_t max_level = 4;
+    float lod_distance_scale = 16.f; // Instances nearer than (radius * lod_distance_scale) use max_level, and the level decreases by 1 for each doubling of the distance.
+    unsigned num_threads = default_thread_count();
+
+    std::vector<SphereInstance> instances;
+    std::vector<InstanceBatch> batches;
+
+    [[nodiscard]] std::uint8_t selectLevel(float distance, float radius) const noexcept{
+        const float level_drop = std::floor(std::log2(std::max(distance / (radius * lod_distance_scale), 1.f)));
+        return static_cast<std::uint8_t>(max_level - std::min(level_drop, static_cast<float>(max_level)));
+    }
+
+    void cull(std::span<const SphereInstance> source, const glm::mat4 &projection_view, const glm::vec3 &view_pos){
+        const Frustum frustum = Frustum::fromMatrix(projection_view);
+
+        /*
+         * Each visible instance gets a 64-bit sort key: upper 32 bits for (max_level - level), and lower 32 bits for
+         * its squared distance to the camera. Bit pattern of a non-negative float is monotonic, therefore sorting the
+         * keys groups the instances by level (finest first) and orders them front-to-back in each group. Equal keys are
+         * ordered by the instance index, so that the result does not depend on the number of chunks.
+         *
+         * Each chunk culls and sorts its own range, and the sorted chunks are merged pairwise afterward.
+         */
+        struct Entry{
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+        const auto key_less = [](const Entry &lhs, const Entry &rhs) noexcept {
+            return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.index < rhs.index;
+        };
+
+        const std::size_t num_chunks = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(source.size(), 1));
+        std::vector<std::vector<Entry>> chunk_entries(num_chunks);
+        parallel_for(std::size_t { 0 }, num_chunks, [&](std::size_t first_chunk, std::size_t last_chunk){
+            for (std::size_t chunk = first_chunk; chunk < last_chunk; ++chunk){
+                std::vector<Entry> &entries = chunk_entries[chunk];
+                const std::size_t first = source.size() * chunk / num_chunks,
+                                  last = source.size() * (chunk + 1) / num_chunks;
+                for (std::size_t index = first; index < last; ++index){
+                    const auto [center, radius] = source[index];
+                    if (!frustum.intersects(center, radius)){
+                        continue;
+                    }
+
+                    const glm::vec3 offset = center - view_pos;
+                    const float distance2 = glm::dot(offset, offset);
+                    const std::uint8_t level = selectLevel(std::sqrt(distance2), radius);
+                    entries.emplace_back(
+                        static_cast<std::uint64_t>(max_level - level) << 32 | std::bit_cast<std::uint32_t>(distance2),
+                        static_cast<std::uint32_t>(index));
+                }
+                std::ranges::sort(entries, key_less);
+            }
+        }, num_threads);
+
+        std::vector<std::size_t> chunk_offsets(num_chunks + 1, 0);
+        for (std::size_t chunk = 0; chunk < num_chunks; ++chunk){
+            chunk_offsets[chunk + 1] = chunk_offsets[chunk] + chunk_entries[chunk].size();
+        }
+
+        std::vector<Entry> entries(chunk_offsets.back());
+        parallel_for(std::size_t { 0 }, num_chunks, [&](std::size_t first_chunk, std::size_t last_chunk){
+            for (std::size_t chunk = first_chunk; chunk < last_chunk; ++chunk){
+                std::ranges::copy(chunk_entries[chunk], entries.begin() + chunk_offsets[chunk]);
+            }
+        }, num_threads);
+
+        for (std::size_t width = 1; width < num_chunks; width *= 2){
+            const std::size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+            parallel_for(std::size_t { 0 }, num_merges, [&](std::size_t first_merge, std::size_t last_merge){
+                for (std::size_t merge = first_merge; merge < last_merge; ++merge){
+                    const std::size_t first = chunk_offsets[2 * width * merge],
+                                      middle = chunk_offsets[std::min(2 * width * merge + width, num_chunks)],
+                                      last = chunk_offsets[std::min(2 * width * (merge + 1), num_chunks)];
+                    std::inplace_merge(entries.begin() + first, entries.begin() + middle, entries.begin() + last, key_less);
+                }
+            }, num_threads);
+        }
+
+        // Gather instances in the sorted order, and split them into batches.
+        instances.resize(entries.size());
+        parallel_for(std::size_t { 0 }, entries.size(), [&](std::size_t first, std::size_t last){
+            for (std::size_t i = first; i < last; ++i){
+                instances[i] = source[entries[i].index];
+            }
+        }, num_threads);
+
+        batches.clear();
+        for (auto it = entries.cbegin(); it != entries.cend();){
+            const std::uint64_t level_key = it->key >> 32;
+            const auto batch_end = std::partition_point(it, entries.cend(), [&](const Entry &entry){
+                return (entry.key >> 32) == level_key;
+            });
+            batches.emplace_back(
+                static_cast<std::uint8_t>(max_level - level_key),
+                static_cast<std::uint32_t>(it - entries.cbegin()),
+                static_cast<std::uint32_t>(batch_end - it));
+            it = batch_end;
+        }
+    }
+};
@@ -0,0 +1,169 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+
+#include <parallel_for.hpp>
+
+#include "icosphere.hpp"
+
+/**
+ * Square sparse matrix in compressed sparse row (CSR) form. The nonzero entries of the row \p i are
+ * <tt>values[row_offsets[i]]</tt>, ..., <tt>values[row_offsets[i + 1] - 1]</tt>, and their columns are stored in
+ * \p column_indices at the same positions. Row offsets are \p std::size_t, since the number of nonzeros may exceed the
+ * range of \p IndexType (e.g. 7V - 12 for the Laplacian of a level 5 icosphere with \p std::uint16_t).
+ */
+template <typename IndexType, typename ValueType = float>
+struct SparseMatrix{
+    std::vector<std::size_t> row_offsets;
+    std::vector<IndexType> column_indices;
+    std::vector<ValueType> values;
+
+    [[nodiscard]] constexpr std::size_t numRows() const noexcept{
+        return row_offsets.size() - 1;
+    }
+
+    [[nodiscard]] constexpr std::size_t numNonZeros() const noexcept{
+        return values.size();
+    }
+};
+
+namespace Laplacian{
+    namespace details{
+        /*
+         * Each row of the Laplacian has the diagonal entry first, followed by the neighbors in the same order as the
+         * adjacency. Therefore, the row offsets are just shifted by the row index.
+         */
+        template <typename IndexType, typename ValueType>
+        SparseMatrix<IndexType, ValueType> makePattern(const VertexAdjacency<IndexType> &adjacency){
+            const std::size_t num_vertices = adjacency.numVertices();
+
+            SparseMatrix<IndexType, ValueType> matrix;
+            matrix.row_offsets.resize(num_vertices + 1);
+            matrix.column_indices.resize(adjacency.neighbor_indices.size() + num_vertices);
+            matrix.values.resize(matrix.column_indices.size());
+
+            for (std::size_t vertex_index = 0; vertex_index <= num_vertices; ++vertex_index){
+                matrix.row_offsets[vertex_index] = adjacency.row_offsets[vertex_index] + vertex_index;
+            }
+
+            parallel_for(std::size_t { 0 }, num_vertices, [&](std::size_t first, std::size_t last){
+                for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                    IndexType *columns = matrix.column_indices.data() + matrix.row_offsets[vertex_index];
+                    columns[0] = static_cast<IndexType>(vertex_index);
+                    std::copy(adjacency.neighbor_indices.cbegin() + adjacency.row_offsets[vertex_index],
+                              adjacency.neighbor_indices.cbegin() + adjacency.row_offsets[vertex_index + 1],
+                              columns + 1);
+                }
+            });
+
+            return matrix;
+        }
+
+        inline float cotangent(const glm::vec3 &apex, const glm::vec3 &p1, const glm::vec3 &p2) noexcept{
+            const glm::vec3 e1 = p1 - apex, e2 = p2 - apex;
+            return glm::dot(e1, e2) / glm::length(glm::cross(e1, e2));
+        }
+    }
+
+    /**
+     * Build the uniform (umbrella) Laplacian, i.e. <tt>(L x)_i = (1 / valence_i) * sum_j (x_j - x_i)</tt> for all
+     * neighbors j of the vertex i.
+     *
+     * @param adjacency Vertex adjacency generated by \p Icosphere::generateAdjacency().
+     * @return Sparse matrix with the diagonal entry first in each row.
+     */
+    template <typename IndexType, typename ValueType = float>
+    SparseMatrix<IndexType, ValueType> uniform(const VertexAdjacency<IndexType> &adjacency){
+        auto matrix = details::makePattern<IndexType, ValueType>(adjacency);
+        parallel_for(std::size_t { 0 }, adjacency.numVertices(), [&](std::size_t first, std::size_t last){
+            for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                const auto valence = static_cast<ValueType>(adjacency.valence(vertex_index));
+                ValueType *row = matrix.values.data() + matrix.row_offsets[vertex_index];
+                row[0] = ValueType { -1 };
+                std::fill(row + 1, matrix.values.data() + matrix.row_offsets[vertex_index + 1], ValueType { 1 } / valence);
+            }
+        });
+        return matrix;
+    }
+
+    /**
+     * Build the cotangent Laplacian, i.e. <tt>(L x)_i = sum_j w_ij (x_j - x_i)</tt> where
+     * <tt>w_ij = (cot(alpha_ij) + cot(beta_ij)) / 2</tt> and alpha_ij, beta_ij are the angles opposite to the edge ij.
+     * The matrix is symmetric and not normalized by the vertex area.
+     *
+     * Since the adjacency rows are ordered counter-clockwise, the opposite vertices of the edge to the k-th neighbor are
+     * the (k-1)-th and (k+1)-th neighbors, and no triangle lookup is needed.
+     *
+     * @param adjacency Vertex adjacency generated by \p Icosphere::generateAdjacency().
+     * @param positions Vertex positions (e.g. \p Mesh::positions , possibly displaced).
+     * @return Sparse matrix with the diagonal entry first in each row.
+     */
+    template <typename IndexType, typename ValueType = float>
+    SparseMatrix<IndexType, ValueType> cotangent(const VertexAdjacency<IndexType> &adjacency, std::span<const glm::vec3> positions){
+        assert(positions.size() == adjacency.numVertices());
+
+        auto matrix = details::makePattern<IndexType, ValueType>(adjacency);
+        parallel_for(std::size_t { 0 }, adjacency.numVertices(), [&](std::size_t first, std::size_t last){
+            for (std::size_t vertex_index = first; vertex_index < last; ++vertex_index){
+                const IndexType *neighbors = adjacency.neighbor_indices.data() + adjacency.row_offsets[vertex_index];
+                const std::size_t valence = adjacency.valence(vertex_index);
+                ValueType *row = matrix.values.data() + matrix.row_offsets[vertex_index];
+                const glm::vec3 &center = positions[vertex_index];
+
+                ValueType diagonal { 0 };
+                for (std::size_t k = 0; k < valence; ++k){
+                    const glm::vec3 &neighbor = positions[neighbors[k]],
+                                    &previous = positions[neighbors[(k + valence - 1) % valence]],
+                                    &next = positions[neighbors[(k + 1) % valence]];
+                    const auto weight = static_cast<ValueType>(
+                        0.5f * (details::cotangent(previous, center, neighbor) + details::cotangent(next, center, neighbor)));
+                    row[k + 1] = weight;
+                    diagonal -= weight;
+                }
+                row[0] = diagonal;
+            }
+        });
+        return matrix;
+    }
+}
+
+/**
+ * Multithreaded sparse matrix-vector multiplication <tt>y = A x</tt>. Rows are split into contiguous chunks, so no
+ * synchronization is needed between threads.
+ *
+ * @param matrix Sparse matrix A.
+ * @param x Input vector, whose size must be the number of columns of A.
+ * @param y Output vector, whose size must be the number of rows of A. It must not alias \p x.
+ * @param num_threads Number of threads to be used.
+ */
+template <typename IndexType, typename ValueType>
+void spmv(const SparseMatrix<IndexType, ValueType> &matrix,
+          std::span<const std::type_identity_t<ValueType>> x,
+          std::span<std::type_identity_t<ValueType>> y,
+          unsigned num_threads = default_thread_count())
+{
+    assert(y.size() == matrix.numRows());
+
+    parallel_for(std::size_t { 0 }, matrix.numRows(), [&](std::size_t first, std::size_t last){
+        const IndexType *const column_indices = matrix.column_indices.data();
+        const ValueType *const values = matrix.values.data();
+        for (std::size_t row = first; row < last; ++row){
+            ValueType sum { 0 };
+            for (std::size_t k = matrix.row_offsets[row]; k < matrix.row_offsets[row + 1]; ++k){
+                sum += values[k] * x[column_indices[k]];
+            }
+            y[row] = sum;
+        }
+    }, num_threads);
+}
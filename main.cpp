@@ -5,13 +5,18 @@
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <random>
+#include <type_traits>
 
 #include <imgui_variant_selector.hpp>
 #include <dirty_property.hpp>
 #include <visitor_helper.hpp>
 #include <measure_execution.hpp>
 
+#include "any_mesh.hpp"
 #include "icosphere.hpp"
+#include "instancing.hpp"
+#include "uniforms.hpp"
 #include "vertex.hpp"
 
 namespace Shading{
@@ -22,27 +27,33 @@ namespace Shading{
     struct Phong {
         std::size_t num_icosphere_positions = 0;
         GLsizei num_icosphere_indices = 0;
+        GLenum index_type = GL_UNSIGNED_INT;
+        std::size_t index_bytes = 0;
+        std::int64_t index_bytes_saved = 0; // Compared to 32-bit indices.
     };
 
-    using Type = std::variant<Flat, Phong>;
+    struct Instanced {
+        // Icospheres of level 0 to (subdivision level) share a single vertex/index buffer.
+        struct Lod {
+            GLint base_vertex;
+            GLsizei first_index;
+            GLsizei num_indices;
+        };
+
+        std::vector<Lod> lods;
+        GLenum index_type = GL_UNSIGNED_INT;
+        std::size_t index_size = sizeof(GLuint);
+    };
+
+    using Type = std::variant<Flat, Phong, Instanced>;
 
     enum class Mode : std::uint8_t {
         Flat,
         Phong,
+        Instanced,
     };
 }
 
-struct MvpMatrixUniform{
-    glm::mat4 model;
-    glm::mat4 inv_model;
-    glm::mat4 projection_view;
-};
-
-struct LightingUniform{
-    alignas(16) glm::vec3 view_pos;  // std140: base alignment must be 16 for vec3.
-    alignas(16) glm::vec3 light_pos; // std140: base alignment must be 16 for vec3.
-};
-
 class Viewer final : public OpenGL::Window {
     DirtyProperty<int> subdivision_level { 0 };
     DirtyProperty<Shading::Mode> shading_mode { Shading::Mode::Phong };
@@ -50,20 +61,27 @@ class Viewer final : public OpenGL::Window {
     DirtyProperty<bool> fix_light_position { false }; // true -> light is fixed at (5, 0, 0), false -> light is at camera position.
     std::chrono::duration<float, std::milli> generation_elapsed;
 
+    DirtyProperty<int> num_instances { 100'000 };
+    std::vector<SphereInstance> sphere_instances;
+    InstanceCuller instance_culler;
+    std::chrono::duration<float, std::milli> culling_elapsed {};
+
     std::optional<glm::vec2> previous_mouse_position;
     OpenGL::PerspectiveCamera camera;
 
     const OpenGL::Program flat_program { "shaders/flat.vert", "shaders/flat.frag" },
-                          phong_program { "shaders/phong.vert", "shaders/phong.frag" };
+                          phong_program { "shaders/phong.vert", "shaders/phong.frag" },
+                          instanced_phong_program { "shaders/instanced_phong.vert", "shaders/phong.frag" };
     DirtyProperty<MvpMatrixUniform> mvp_matrix;
     DirtyProperty<LightingUniform> lighting;
 
     GLuint vao;
-    std::array<GLuint, 4> buffer_objects;
+    std::array<GLuint, 5> buffer_objects;
     GLuint &vbo            = std::get<0>(buffer_objects),
            &ebo            = std::get<1>(buffer_objects),
            &mvp_matrix_ubo = std::get<2>(buffer_objects),
-           &lighting_ubo   = std::get<3>(buffer_objects);
+           &lighting_ubo   = std::get<3>(buffer_objects),
+           &instance_vbo   = std::get<4>(buffer_objects);
 
     void onFramebufferSizeChanged(int width, int height) override {
         OpenGL::Window::onFramebufferSizeChanged(width, height);
@@ -177,42 +195,140 @@ class Viewer final : public OpenGL::Window {
                                           sizeof(Vertex),
                                           reinterpret_cast<const GLint*>(offsetof(Vertex, normal)));
                     glEnableVertexAttribArray(1);
+                    glDisableVertexAttribArray(2);
 
                     break;
                 }
                 case Mode::Phong: {
                     // Create vertices with elapsed time measurement.
+                    // Index type is the smallest one for the subdivision level.
                     const auto &&[new_icosphere, elapsed] = measure_execution_with_result([&]{
-                        return Icosphere<unsigned int>::generate(subdivision_level);
+                        return AnyMesh::generate(subdivision_level);
                     });
                     generation_elapsed = elapsed;
 
                     shading = Shading::Phong {
-                        .num_icosphere_positions = new_icosphere.positions.size(),
-                        .num_icosphere_indices = 3 * static_cast<GLsizei>(new_icosphere.triangle_indices.size())
+                        .num_icosphere_positions = new_icosphere.positions().size(),
+                        .num_icosphere_indices = 3 * static_cast<GLsizei>(new_icosphere.numTriangles()),
+                        .index_type = getGLIndexType(new_icosphere.indexSize()),
+                        .index_bytes = new_icosphere.indexBytes(),
+                        .index_bytes_saved = AnyMesh::indexBytesSaved(subdivision_level),
                     };
 
                     glBindVertexArray(vao);
 
                     glBindBuffer(GL_ARRAY_BUFFER, vbo);
                     glBufferData(GL_ARRAY_BUFFER,
-                                 static_cast<GLsizei>(new_icosphere.positions.size() * sizeof(glm::vec3)),
-                                 new_icosphere.positions.data(),
+                                 static_cast<GLsizei>(new_icosphere.positions().size() * sizeof(glm::vec3)),
+                                 new_icosphere.positions().data(),
                                  GL_STATIC_DRAW);
 
                     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
                     glEnableVertexAttribArray(0);
                     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
                     glEnableVertexAttribArray(1); // for sphere, all vertex position is also normal too.
+                    glDisableVertexAttribArray(2);
 
                     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
                     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                                 static_cast<GLsizei>(new_icosphere.triangle_indices.size() * sizeof(Mesh<unsigned int>::triangle_index_t)),
-                                 new_icosphere.triangle_indices.data(), GL_STATIC_DRAW);
+                                 static_cast<GLsizei>(new_icosphere.indexBytes()),
+                                 new_icosphere.indexData(), GL_STATIC_DRAW);
+
+                    break;
+                }
+                case Mode::Instanced: {
+                    /*
+                     * Each level is drawn with its own base vertex, so its indices are local to the level. All levels use
+                     * the smallest index type of the finest one (16-bit up to level 6).
+                     */
+                    const std::size_t index_size = AnyMesh::indexSize(subdivision_level);
+                    Shading::Instanced instanced_shading {
+                        .lods = {},
+                        .index_type = getGLIndexType(index_size),
+                        .index_size = index_size,
+                    };
+
+                    const auto upload_lods = [&]<typename IndexType>(std::type_identity<IndexType>){
+                        // Create icospheres of all levels up to subdivision_level with elapsed time measurement.
+                        const auto &&[lod_icospheres, elapsed] = measure_execution_with_result([&]{
+                            std::vector<Mesh<IndexType>> icospheres;
+                            for (std::uint8_t level = 0; level <= subdivision_level; ++level){
+                                icospheres.push_back(Icosphere<IndexType>::generate(level));
+                            }
+                            return icospheres;
+                        });
+                        generation_elapsed = elapsed;
+
+                        Mesh<IndexType> merged;
+                        for (const Mesh<IndexType> &icosphere : lod_icospheres){
+                            instanced_shading.lods.emplace_back(
+                                static_cast<GLint>(merged.positions.size()),
+                                3 * static_cast<GLsizei>(merged.triangle_indices.size()),
+                                3 * static_cast<GLsizei>(icosphere.triangle_indices.size()));
+                            merged.positions.insert(merged.positions.end(), icosphere.positions.cbegin(), icosphere.positions.cend());
+                            merged.triangle_indices.insert(merged.triangle_indices.end(), icosphere.triangle_indices.cbegin(), icosphere.triangle_indices.cend());
+                        }
+
+                        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+                        glBufferData(GL_ARRAY_BUFFER,
+                                     static_cast<GLsizei>(merged.positions.size() * sizeof(glm::vec3)),
+                                     merged.positions.data(),
+                                     GL_STATIC_DRAW);
+
+                        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+                        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                                     static_cast<GLsizei>(merged.triangle_indices.size() * sizeof(typename Mesh<IndexType>::triangle_index_t)),
+                                     merged.triangle_indices.data(), GL_STATIC_DRAW);
+                    };
+
+                    glBindVertexArray(vao);
+                    if (index_size == sizeof(GLushort)){
+                        upload_lods(std::type_identity<GLushort>{});
+                    }
+                    else{
+                        upload_lods(std::type_identity<GLuint>{});
+                    }
+                    shading = std::move(instanced_shading);
+                    instance_culler.max_level = subdivision_level;
+
+                    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+                    glEnableVertexAttribArray(1); // for sphere, all vertex position is also normal too.
+
+                    // Per-instance attribute. Its pointer is set for each batch in draw().
+                    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+                    glVertexAttribDivisor(2, 1);
+                    glEnableVertexAttribArray(2);
+
+                    break;
                 }
             }
         }, subdivision_level, shading_mode);
 
+        // Instances are regenerated when the count is changed.
+        num_instances.clean([&](int count){
+            sphere_instances = generateSphereInstances(count);
+        });
+
+        // Instances are culled, LOD-selected and sorted for every frame.
+        if (std::holds_alternative<Shading::Instanced>(shading)){
+            const MvpMatrixUniform &mvp = mvp_matrix.value();
+            culling_elapsed = measure_execution([&]{
+                // Culling is done in the model space.
+                instance_culler.cull(sphere_instances,
+                                     mvp.projection_view * mvp.model,
+                                     glm::vec3 { mvp.inv_model * glm::vec4 { camera.view.getPosition(), 1.f } });
+            });
+
+            glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+            glBufferData(GL_ARRAY_BUFFER,
+                         static_cast<GLsizei>(instance_culler.instances.size() * sizeof(SphereInstance)),
+                         instance_culler.instances.data(),
+                         GL_STREAM_DRAW);
+        }
+
         // MVP Matrix UBO should be updated when it changed.
         mvp_matrix.clean([&](const MvpMatrixUniform &value){
             glBindBuffer(GL_UNIFORM_BUFFER, mvp_matrix_ubo);
@@ -235,7 +351,7 @@ class Viewer final : public OpenGL::Window {
     }
 
     void draw() const override {
-        glClear(GL_COLOR_BUFFER_BIT);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         std::visit(overload{
             [&](const Shading::Flat &flat_shading){
@@ -248,13 +364,59 @@ class Viewer final : public OpenGL::Window {
                 phong_program.use();
 
                 glBindVertexArray(vao);
-                glDrawElements(GL_TRIANGLES, phong_shading.num_icosphere_indices, GL_UNSIGNED_INT, nullptr);
+                glDrawElements(GL_TRIANGLES, phong_shading.num_icosphere_indices, phong_shading.index_type, nullptr);
+            },
+            [&](const Shading::Instanced &instanced_shading){
+                instanced_phong_program.use();
+
+                glBindVertexArray(vao);
+                glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+                for (const InstanceBatch &batch : instance_culler.batches){
+                    const Shading::Instanced::Lod &lod = instanced_shading.lods[batch.level];
+                    glVertexAttribPointer(2,
+                                          4,
+                                          GL_FLOAT,
+                                          GL_FALSE,
+                                          sizeof(SphereInstance),
+                                          reinterpret_cast<const void*>(batch.first_instance * sizeof(SphereInstance)));
+                    glDrawElementsInstancedBaseVertex(GL_TRIANGLES,
+                                                      lod.num_indices,
+                                                      instanced_shading.index_type,
+                                                      reinterpret_cast<const void*>(lod.first_index * instanced_shading.index_size),
+                                                      static_cast<GLsizei>(batch.instance_count),
+                                                      lod.base_vertex);
+                }
             }
         }, shading);
 
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
 
+    static GLenum getGLIndexType(std::size_t index_size){
+        switch (index_size) {
+            case sizeof(GLushort): return GL_UNSIGNED_SHORT;
+            case sizeof(GLuint): return GL_UNSIGNED_INT;
+            default: throw std::invalid_argument { "OpenGL does not support the index type of the given size." };
+        }
+    }
+
+    static std::vector<SphereInstance> generateSphereInstances(int count){
+        // Spheres are scattered uniformly in a cube, whose size is proportional to the cube root of the count so that
+        // the density is kept.
+        const float half_extent = 1.5f * std::cbrt(static_cast<float>(count));
+
+        std::mt19937 random_engine { 0 };
+        std::uniform_real_distribution<float> center_distribution { -half_extent, half_extent },
+                                              radius_distribution { 0.2f, 0.6f };
+
+        std::vector<SphereInstance> instances(count);
+        std::ranges::generate(instances, [&]{
+            const glm::vec3 center { center_distribution(random_engine), center_distribution(random_engine), center_distribution(random_engine) };
+            return SphereInstance { center, radius_distribution(random_engine) };
+        });
+        return instances;
+    }
+
     glm::vec3 getLightPosition() const{
         return fix_light_position.value() ? glm::vec3 { 5.f, 0.f, 0.f } : camera.view.getPosition();
     }
@@ -309,6 +471,9 @@ class Viewer final : public OpenGL::Window {
         if (ImGui::RadioButton("Phong shading", shading_mode.value() == Shading::Mode::Phong)) {
             shading_mode = Shading::Mode::Phong;
         }
+        if (ImGui::RadioButton("Instanced Phong shading", shading_mode.value() == Shading::Mode::Instanced)) {
+            shading_mode = Shading::Mode::Instanced;
+        }
 
         std::visit(overload {
             [](const Shading::Flat &shading) {
@@ -317,6 +482,21 @@ class Viewer final : public OpenGL::Window {
             [](const Shading::Phong &shading) {
                 ImGui::Text("# of positions: %zu", shading.num_icosphere_positions);
                 ImGui::Text("# of indices: %d", shading.num_icosphere_indices);
+                ImGui::Text("Index type: %s (%zu bytes, %lld bytes saved)",
+                            shading.index_type == GL_UNSIGNED_SHORT ? "GL_UNSIGNED_SHORT" : "GL_UNSIGNED_INT",
+                            shading.index_bytes,
+                            static_cast<long long>(shading.index_bytes_saved));
+            },
+            [&](const Shading::Instanced &shading) {
+                if (int num_instances_input = num_instances.value();
+                    ImGui::InputInt("# of instances", &num_instances_input, 10'000, 100'000, ImGuiInputTextFlags_EnterReturnsTrue))
+                {
+                    num_instances = std::clamp(num_instances_input, 0, 10'000'000);
+                }
+                ImGui::Text("# of visible instances: %zu", instance_culler.instances.size());
+                ImGui::Text("# of draw calls: %zu", instance_culler.batches.size());
+                ImGui::Text("Index type: %s", shading.index_type == GL_UNSIGNED_SHORT ? "GL_UNSIGNED_SHORT" : "GL_UNSIGNED_INT");
+                ImGui::Text("Culling time: %.3f ms", culling_elapsed.count());
             },
         }, shading);
         ImGui::Text("Generation time: %.3f ms", generation_elapsed.count());
@@ -350,7 +530,7 @@ public:
             glBindBuffer(GL_UNIFORM_BUFFER, mvp_matrix_ubo);
             glBufferData(GL_UNIFORM_BUFFER, sizeof(MvpMatrixUniform), nullptr, GL_DYNAMIC_DRAW);
 
-            OpenGL::Program::setUniformBlockBindings("MvpMatrix", 0, flat_program, phong_program);
+            OpenGL::Program::setUniformBlockBindings("MvpMatrix", 0, flat_program, phong_program, instanced_phong_program);
             glBindBufferBase(GL_UNIFORM_BUFFER, 0, mvp_matrix_ubo);
         }
 
@@ -359,13 +539,16 @@ public:
             glBindBuffer(GL_UNIFORM_BUFFER, lighting_ubo);
             glBufferData(GL_UNIFORM_BUFFER, sizeof(LightingUniform), nullptr, GL_DYNAMIC_DRAW);
 
-            OpenGL::Program::setUniformBlockBindings("Lighting", 1, flat_program, phong_program);
+            OpenGL::Program::setUniformBlockBindings("Lighting", 1, flat_program, phong_program, instanced_phong_program);
             glBindBufferBase(GL_UNIFORM_BUFFER, 1, lighting_ubo);
         }
 
         // Front face of triangles are counter-clockwise.
         glEnable(GL_CULL_FACE);
 
+        // Instanced spheres can overlap each other.
+        glEnable(GL_DEPTH_TEST);
+
         initImGui();
     }
 
@@ -0,0 +1,462 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/ext/vector_float3.hpp>
+
+#include <parallel_for.hpp>
+
+#include "icosphere.hpp"
+#include "vertex.hpp"
+
+enum class MeshFormat{
+    PlyBinary, // Binary PLY in the native byte order.
+    PlyAscii,
+    Obj,
+};
+
+struct ExportOptions{
+    std::size_t buffer_size = std::size_t { 1 } << 20; // Size of each formatting buffer in bytes (at least 256).
+    unsigned num_threads = 1; // Number of chunks formatted in parallel, each into its own buffer.
+};
+
+/**
+ * Result of the \p MeshExport functions.
+ */
+struct ExportResult{
+    std::size_t bytes;
+    std::chrono::duration<double, std::milli> elapsed;
+
+    [[nodiscard]] double megabytesPerSecond() const noexcept{
+        return static_cast<double>(bytes) / std::chrono::duration<double>(elapsed).count() * 1e-6;
+    }
+};
+
+/**
+ * Streaming writer of PLY (binary/ASCII) and OBJ meshes, whose element counts are given in advance. Vertices and
+ * triangles are passed in blocks of any size (all vertices first), formatted by \p std::to_chars into fixed-size buffers
+ * and written to the stream in large blocks. With <tt>ExportOptions::num_threads > 1</tt>, consecutive chunks of a block
+ * are formatted in parallel and written in order, so the memory usage is always <tt>num_threads * buffer_size</tt>.
+ *
+ * Vertices are either positions only, or positions with normals (\p Vertex). In OBJ, normals are written as \p vn with
+ * the same indices as the positions.
+ *
+ * @code
+ * std::ofstream file { "sphere.ply", std::ios::binary };
+ * MeshWriter writer { file, MeshFormat::PlyBinary, mesh.positions.size(), mesh.triangle_indices.size() };
+ * writer.writePositions(mesh.positions);
+ * writer.writeTriangles<std::uint32_t>(mesh.triangle_indices);
+ * writer.finish();
+ * @endcode
+ */
+class MeshWriter{
+private:
+    static constexpr std::size_t max_float_chars = 16; // "-1.17549435e-38" is the longest shortest representation.
+    static constexpr std::size_t max_index_chars = std::numeric_limits<std::uint64_t>::digits10 + 1;
+
+    std::ostream &stream;
+    MeshFormat format;
+    bool has_normals;
+    std::size_t num_vertices, num_triangles;
+    std::size_t index_size; // Size of a vertex index in binary PLY (2 or 4 bytes).
+    unsigned num_threads;
+
+    std::vector<std::vector<char>> buffers;
+    std::vector<std::size_t> buffer_sizes;
+    std::size_t num_written_vertices = 0, num_written_triangles = 0;
+    std::size_t bytes_written = 0;
+
+    static char *formatFloat(char *out, float value) noexcept{
+        return std::to_chars(out, out + max_float_chars, value).ptr;
+    }
+
+    static char *formatIndex(char *out, std::uint64_t value) noexcept{
+        return std::to_chars(out, out + max_index_chars, value).ptr;
+    }
+
+    template <typename T>
+    static char *writeBinary(char *out, T value) noexcept{
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static char *formatVector(char *out, const glm::vec3 &v) noexcept{
+        out = formatFloat(out, v.x);
+        *out++ = ' ';
+        out = formatFloat(out, v.y);
+        *out++ = ' ';
+        return formatFloat(out, v.z);
+    }
+
+    void writeRaw(const char *data, std::size_t size){
+        stream.write(data, static_cast<std::streamsize>(size));
+        if (!stream){
+            throw std::runtime_error { "Failed to write the mesh to the stream." };
+        }
+        bytes_written += size;
+    }
+
+    /*
+     * Format the elements [0, count) by format(out, element_index) -> new_out, which writes at most max_element_size
+     * bytes. Each round fills all buffers in parallel, and writes them in order.
+     */
+    template <typename FormatFn>
+    void writeElements(std::size_t count, std::size_t max_element_size, FormatFn &&format_element){
+        const std::size_t elements_per_buffer = buffers.front().size() / max_element_size;
+        for (std::size_t round_first = 0; round_first < count; round_first += elements_per_buffer * buffers.size()){
+            const std::size_t round_count = std::min(count - round_first, elements_per_buffer * buffers.size());
+            const std::size_t num_buffers = (round_count + elements_per_buffer - 1) / elements_per_buffer;
+            parallel_for(std::size_t { 0 }, num_buffers, [&](std::size_t first_buffer, std::size_t last_buffer){
+                for (std::size_t buffer_index = first_buffer; buffer_index < last_buffer; ++buffer_index){
+                    const std::size_t first = round_first + buffer_index * elements_per_buffer,
+                                      last = std::min(first + elements_per_buffer, round_first + round_count);
+                    char *const begin = buffers[buffer_index].data();
+                    char *out = begin;
+                    for (std::size_t element_index = first; element_index < last; ++element_index){
+                        out = format_element(out, element_index);
+                    }
+                    buffer_sizes[buffer_index] = static_cast<std::size_t>(out - begin);
+                }
+            }, num_threads);
+
+            for (std::size_t buffer_index = 0; buffer_index < num_buffers; ++buffer_index){
+                writeRaw(buffers[buffer_index].data(), buffer_sizes[buffer_index]);
+            }
+        }
+    }
+
+    void beginVertices(std::size_t count, bool normals){
+        if (normals != has_normals){
+            throw std::invalid_argument { has_normals ? "Vertices must have normals." : "Vertices must not have normals." };
+        }
+        if (num_written_vertices + count > num_vertices){
+            throw std::invalid_argument { "More vertices than " + std::to_string(num_vertices) + " are written." };
+        }
+        num_written_vertices += count;
+    }
+
+    void beginTriangles(std::size_t count){
+        if (num_written_vertices != num_vertices){
+            throw std::invalid_argument { "Triangles must be written after all vertices." };
+        }
+        if (num_written_triangles + count > num_triangles){
+            throw std::invalid_argument { "More triangles than " + std::to_string(num_triangles) + " are written." };
+        }
+        num_written_triangles += count;
+    }
+
+    // Write the triangles [0, count) by indices(triangle_index) -> std::array<std::uint64_t, 3>, 0-based.
+    template <typename IndicesFn>
+    void writeTriangleIndices(std::size_t count, IndicesFn &&indices){
+        switch (format){
+            case MeshFormat::PlyBinary:
+                writeElements(count, 1 + 3 * index_size, [&](char *out, std::size_t triangle_index){
+                    out = writeBinary(out, std::uint8_t { 3 });
+                    for (std::uint64_t index : indices(triangle_index)){
+                        out = index_size == 2 ? writeBinary(out, static_cast<std::uint16_t>(index)) : writeBinary(out, static_cast<std::uint32_t>(index));
+                    }
+                    return out;
+                });
+                break;
+            case MeshFormat::PlyAscii:
+                writeElements(count, 2 + 3 * (max_index_chars + 1), [&](char *out, std::size_t triangle_index){
+                    *out++ = '3';
+                    for (std::uint64_t index : indices(triangle_index)){
+                        *out++ = ' ';
+                        out = formatIndex(out, index);
+                    }
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+            case MeshFormat::Obj:
+                // 1-based, and "f a//a b//b c//c" if the vertices have normals.
+                writeElements(count, 2 + 3 * (2 * max_index_chars + 3), [&](char *out, std::size_t triangle_index){
+                    *out++ = 'f';
+                    for (std::uint64_t index : indices(triangle_index)){
+                        *out++ = ' ';
+                        out = formatIndex(out, index + 1);
+                        if (has_normals){
+                            *out++ = '/';
+                            *out++ = '/';
+                            out = formatIndex(out, index + 1);
+                        }
+                    }
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+        }
+    }
+
+public:
+    /**
+     * Create the writer and write the header.
+     * @param stream Output stream, which should be opened in binary mode.
+     * @param format Output format.
+     * @param num_vertices Number of vertices to be written.
+     * @param num_triangles Number of triangles to be written.
+     * @param has_normals Whether vertices have normals, i.e. written by \p writeVertices() instead of \p writePositions().
+     * @param options Buffer size and number of threads.
+     * @throw std::invalid_argument If <tt>options.buffer_size</tt> is less than 256.
+     * @throw std::overflow_error If the vertex indices cannot be represented by 32-bit PLY indices.
+     */
+    MeshWriter(std::ostream &stream, MeshFormat format, std::size_t num_vertices, std::size_t num_triangles,
+               bool has_normals = false, ExportOptions options = {})
+            : stream { stream }, format { format }, has_normals { has_normals },
+              num_vertices { num_vertices }, num_triangles { num_triangles },
+              index_size { num_vertices <= std::size_t { 1 } << 16 ? 2U : 4U },
+              num_threads { std::max(options.num_threads, 1U) },
+              buffers(num_threads), buffer_sizes(num_threads)
+    {
+        if (options.buffer_size < 256){
+            throw std::invalid_argument { "Buffer size must be at least 256 bytes." };
+        }
+        if (format != MeshFormat::Obj && num_vertices > std::size_t { std::numeric_limits<std::uint32_t>::max() } + 1){
+            throw std::overflow_error { "PLY vertex indices cannot represent " + std::to_string(num_vertices) + " vertices." };
+        }
+        for (std::vector<char> &buffer : buffers){
+            buffer.resize(options.buffer_size);
+        }
+
+        std::string header;
+        if (format == MeshFormat::Obj){
+            header = "# " + std::to_string(num_vertices) + " vertices, " + std::to_string(num_triangles) + " triangles\n";
+        }
+        else{
+            header = "ply\nformat ";
+            header += format == MeshFormat::PlyAscii ? "ascii" : std::endian::native == std::endian::little ? "binary_little_endian" : "binary_big_endian";
+            header += " 1.0\nelement vertex " + std::to_string(num_vertices) + "\nproperty float x\nproperty float y\nproperty float z\n";
+            if (has_normals){
+                header += "property float nx\nproperty float ny\nproperty float nz\n";
+            }
+            header += "element face " + std::to_string(num_triangles) + "\nproperty list uchar ";
+            header += index_size == 2 ? "ushort" : "uint";
+            header += " vertex_indices\nend_header\n";
+        }
+        writeRaw(header.data(), header.size());
+    }
+
+    /**
+     * Write the next block of vertex positions.
+     * @throw std::invalid_argument If the vertices have normals, or more vertices than declared are written.
+     * @throw std::runtime_error If the stream fails.
+     */
+    void writePositions(std::span<const glm::vec3> positions){
+        beginVertices(positions.size(), false);
+        switch (format){
+            case MeshFormat::PlyBinary:
+                writeElements(positions.size(), sizeof(glm::vec3), [&](char *out, std::size_t i){
+                    out = writeBinary(out, positions[i].x);
+                    out = writeBinary(out, positions[i].y);
+                    return writeBinary(out, positions[i].z);
+                });
+                break;
+            case MeshFormat::PlyAscii:
+                writeElements(positions.size(), 3 * (max_float_chars + 1), [&](char *out, std::size_t i){
+                    out = formatVector(out, positions[i]);
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+            case MeshFormat::Obj:
+                writeElements(positions.size(), 2 + 3 * (max_float_chars + 1), [&](char *out, std::size_t i){
+                    *out++ = 'v';
+                    *out++ = ' ';
+                    out = formatVector(out, positions[i]);
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+        }
+    }
+
+    /**
+     * Write the next block of vertices with normals.
+     * @throw std::invalid_argument If the vertices do not have normals, or more vertices than declared are written.
+     * @throw std::runtime_error If the stream fails.
+     */
+    void writeVertices(std::span<const Vertex> vertices){
+        beginVertices(vertices.size(), true);
+        switch (format){
+            case MeshFormat::PlyBinary:
+                writeElements(vertices.size(), 2 * sizeof(glm::vec3), [&](char *out, std::size_t i){
+                    for (const glm::vec3 &v : { vertices[i].position, vertices[i].normal }){
+                        out = writeBinary(out, v.x);
+                        out = writeBinary(out, v.y);
+                        out = writeBinary(out, v.z);
+                    }
+                    return out;
+                });
+                break;
+            case MeshFormat::PlyAscii:
+                writeElements(vertices.size(), 6 * (max_float_chars + 1), [&](char *out, std::size_t i){
+                    out = formatVector(out, vertices[i].position);
+                    *out++ = ' ';
+                    out = formatVector(out, vertices[i].normal);
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+            case MeshFormat::Obj:
+                writeElements(vertices.size(), 5 + 6 * (max_float_chars + 1), [&](char *out, std::size_t i){
+                    *out++ = 'v';
+                    *out++ = ' ';
+                    out = formatVector(out, vertices[i].position);
+                    *out++ = '\n';
+                    *out++ = 'v';
+                    *out++ = 'n';
+                    *out++ = ' ';
+                    out = formatVector(out, vertices[i].normal);
+                    *out++ = '\n';
+                    return out;
+                });
+                break;
+        }
+    }
+
+    /**
+     * Write the next block of triangles (0-based vertex indices).
+     * @throw std::invalid_argument If not all vertices are written yet, or more triangles than declared are written.
+     * @throw std::runtime_error If the stream fails.
+     */
+    template <typename IndexType>
+    void writeTriangles(std::span<const std::array<IndexType, 3>> triangles){
+        beginTriangles(triangles.size());
+        writeTriangleIndices(triangles.size(), [&](std::size_t triangle_index){
+            const auto [i1, i2, i3] = triangles[triangle_index];
+            return std::array<std::uint64_t, 3> { i1, i2, i3 };
+        });
+    }
+
+    /**
+     * Write the next \p count triangles of a flat vertex buffer, where the vertices (3k, 3k + 1, 3k + 2) form the k-th
+     * triangle, as drawn by \p glDrawArrays.
+     * @throw std::invalid_argument If not all vertices are written yet, or more triangles than declared are written.
+     * @throw std::runtime_error If the stream fails.
+     */
+    void writeTriangleList(std::size_t count){
+        const std::size_t first_vertex = 3 * num_written_triangles;
+        beginTriangles(count);
+        writeTriangleIndices(count, [&](std::size_t triangle_index) -> std::array<std::uint64_t, 3> {
+            const std::uint64_t vertex_index = first_vertex + 3 * triangle_index;
+            return { vertex_index, vertex_index + 1, vertex_index + 2 };
+        });
+    }
+
+    /**
+     * Check that all declared elements are written, and flush the stream.
+     * @throw std::runtime_error If any element is missing or the stream fails.
+     */
+    void finish(){
+        if (num_written_vertices != num_vertices || num_written_triangles != num_triangles){
+            throw std::runtime_error {
+                "Only " + std::to_string(num_written_vertices) + " vertices and " + std::to_string(num_written_triangles)
+                    + " triangles are written, but " + std::to_string(num_vertices) + " and " + std::to_string(num_triangles) + " are declared."
+            };
+        }
+        stream.flush();
+        if (!stream){
+            throw std::runtime_error { "Failed to flush the mesh to the stream." };
+        }
+    }
+
+    [[nodiscard]] std::size_t bytesWritten() const noexcept{
+        return bytes_written;
+    }
+};
+
+namespace MeshExport{
+    namespace details{
+        inline std::ofstream open(const std::filesystem::path &path){
+            std::ofstream file { path, std::ios::binary };
+            if (!file){
+                throw std::runtime_error { "Failed to open " + path.string() };
+            }
+            return file;
+        }
+
+        template <typename Fn>
+        ExportResult measure(Fn &&func){
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t bytes = func();
+            return { bytes, std::chrono::steady_clock::now() - start };
+        }
+    }
+
+    /**
+     * Write the indexed mesh to the file.
+     * @return Written bytes and elapsed time.
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    template <typename IndexType>
+    ExportResult writeMesh(const std::filesystem::path &path, const Mesh<IndexType> &mesh, MeshFormat format, ExportOptions options = {}){
+        return details::measure([&]{
+            std::ofstream file = details::open(path);
+            MeshWriter writer { file, format, mesh.positions.size(), mesh.triangle_indices.size(), false, options };
+            writer.writePositions(mesh.positions);
+            writer.template writeTriangles<IndexType>(mesh.triangle_indices);
+            writer.finish();
+            return writer.bytesWritten();
+        });
+    }
+
+    /**
+     * Write the flat vertex buffer (every 3 consecutive vertices form a triangle, e.g. for flat shading) to the file,
+     * with the normals.
+     * @return Written bytes and elapsed time.
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    inline ExportResult writeFlat(const std::filesystem::path &path, std::span<const Vertex> vertices, MeshFormat format, ExportOptions options = {}){
+        return details::measure([&]{
+            std::ofstream file = details::open(path);
+            MeshWriter writer { file, format, vertices.size(), vertices.size() / 3, true, options };
+            writer.writeVertices(vertices);
+            writer.writeTriangleList(vertices.size() / 3);
+            writer.finish();
+            return writer.bytesWritten();
+        });
+    }
+
+    /**
+     * Write the geodesic sphere of the given frequency to the file while generating it by
+     * \p Icosphere::streamGeodesic(), without storing the whole mesh. The output is the same as writing
+     * \p Icosphere::generateGeodesic() by \p writeMesh().
+     * @return Written bytes and elapsed time (including the generation).
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    template <typename IndexType = std::uint32_t>
+    ExportResult writeGeodesic(const std::filesystem::path &path, std::uint32_t frequency, MeshFormat format, ExportOptions options = {}){
+        return details::measure([&]{
+            std::ofstream file = details::open(path);
+            MeshWriter writer {
+                file, format,
+                Icosphere<IndexType>::numGeodesicPositions(frequency), Icosphere<IndexType>::numGeodesicTriangles(frequency),
+                false, options,
+            };
+            Icosphere<IndexType>::streamGeodesic(frequency,
+                [&](std::span<const glm::vec3> positions){ writer.writePositions(positions); },
+                [&](std::span<const std::array<IndexType, 3>> triangles){ writer.writeTriangles(triangles); });
+            writer.finish();
+            return writer.bytesWritten();
+        });
+    }
+}
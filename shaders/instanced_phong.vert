@@ -0,0 +1,20 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec4 aInstance; // xyz: center, w: radius.
+
+out vec3 fragPos;
+out vec3 normal;
+
+layout (std140) uniform MvpMatrix{
+    mat4 model;
+    mat4 inv_model;
+    mat4 projection_view;
+};
+
+void main(){
+    fragPos = vec3(model * vec4(aInstance.xyz + aInstance.w * aPos, 1.0));
+    normal = mat3(transpose(inv_model)) * aNormal;
+    gl_Position = projection_view * vec4(fragPos, 1.0);
+}
\ No newline at end of file
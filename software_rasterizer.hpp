@@ -0,0 +1,573 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/matrix_float3x3.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include <parallel_for.hpp>
+
+#include "icosphere.hpp"
+#include "uniforms.hpp"
+#include "vertex.hpp"
+
+/**
+ * Lighting model of the shaders. \p flat.vert evaluates it per vertex, and \p phong.frag evaluates it per fragment.
+ * The constants must be kept in sync with the shaders.
+ */
+namespace LightingModel{
+    struct Material{
+        glm::vec3 ambient;
+        glm::vec3 diffuse;
+        glm::vec3 specular;
+        float shininess;
+    };
+
+    struct PointLight{
+        glm::vec3 ambient;
+        glm::vec3 diffuse;
+        glm::vec3 specular;
+
+        float constant;
+        float linear;
+        float quadratic;
+    };
+
+    constexpr Material material {
+        glm::vec3 { 0.2f, 0.5f, 1.0f },
+        glm::vec3 { 0.2f, 0.5f, 1.0f },
+        glm::vec3 { 0.5f },
+        32.f
+    };
+
+    constexpr PointLight light {
+        glm::vec3 { 0.1f },
+        glm::vec3 { 1.0f },
+        glm::vec3 { 1.0f },
+        1.0f,
+        0.02f,
+        1.7e-3f
+    };
+
+    /**
+     * Evaluate the lighting at the given world space position.
+     * @param frag_pos World space position.
+     * @param normal Normalized world space normal.
+     * @param lighting Lighting uniform values.
+     * @return Lit color (not clamped).
+     */
+    inline glm::vec3 shade(const glm::vec3 &frag_pos, const glm::vec3 &normal, const LightingUniform &lighting) noexcept{
+        // ambient
+        const glm::vec3 ambient = light.ambient * material.ambient;
+
+        // diffuse
+        const glm::vec3 light_dir = glm::normalize(lighting.light_pos - frag_pos);
+        const float diff = std::max(glm::dot(normal, light_dir), 0.f);
+        const glm::vec3 diffuse = light.diffuse * (diff * material.diffuse);
+
+        // specular
+        const glm::vec3 view_dir = glm::normalize(lighting.view_pos - frag_pos);
+        const glm::vec3 reflect_dir = glm::reflect(-light_dir, normal);
+        const float spec = std::pow(std::max(glm::dot(view_dir, reflect_dir), 0.f), material.shininess);
+        const glm::vec3 specular = light.specular * (spec * material.specular);
+
+        // attenuation
+        const float d = glm::distance(lighting.light_pos, frag_pos);
+        const float attenuation = 1.f / (light.constant + light.linear * d + light.quadratic * d * d);
+
+        return attenuation * (ambient + diffuse + specular);
+    }
+}
+
+/**
+ * 8-bit RGB image, stored row-major from the top row.
+ */
+struct Image{
+    int width;
+    int height;
+    std::vector<std::array<std::uint8_t, 3>> pixels;
+};
+
+/**
+ * Write the image as binary PPM (P6).
+ * @throw std::runtime_error If the file cannot be written.
+ */
+inline void writePpm(const std::filesystem::path &path, const Image &image){
+    std::ofstream file { path, std::ios::binary };
+    file << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size() * 3));
+    if (!file){
+        throw std::runtime_error { "Failed to write " + path.string() };
+    }
+}
+
+/**
+ * Read the binary PPM (P6) image with 8-bit channels, which is written by \p writePpm().
+ * @throw std::runtime_error If the file cannot be read or is not a supported PPM.
+ */
+inline Image readPpm(const std::filesystem::path &path){
+    std::ifstream file { path, std::ios::binary };
+    std::string magic;
+    int max_value;
+    Image image {};
+    file >> magic >> image.width >> image.height >> max_value;
+    file.get(); // Single whitespace after the header.
+    if (!file || magic != "P6" || max_value != 255 || image.width <= 0 || image.height <= 0){
+        throw std::runtime_error { "Failed to read PPM header of " + path.string() };
+    }
+
+    image.pixels.resize(static_cast<std::size_t>(image.width) * image.height);
+    file.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size() * 3));
+    if (!file){
+        throw std::runtime_error { "Failed to read PPM pixels of " + path.string() };
+    }
+    return image;
+}
+
+struct ImageDifference{
+    std::uint8_t max_difference; // Maximum absolute difference among all channels.
+    std::size_t num_different_pixels; // Number of pixels which have a channel difference larger than the tolerance.
+};
+
+/**
+ * Compare two images per pixel, for regression test of the rendering.
+ * @throw std::invalid_argument If the image sizes are different.
+ */
+inline ImageDifference compareImages(const Image &lhs, const Image &rhs, std::uint8_t tolerance = 0){
+    if (lhs.width != rhs.width || lhs.height != rhs.height){
+        throw std::invalid_argument { "Image sizes are different." };
+    }
+
+    ImageDifference difference { 0, 0 };
+    for (std::size_t i = 0; i < lhs.pixels.size(); ++i){
+        std::uint8_t pixel_difference = 0;
+        for (std::size_t channel = 0; channel < 3; ++channel){
+            pixel_difference = std::max<std::uint8_t>(pixel_difference, std::abs(lhs.pixels[i][channel] - rhs.pixels[i][channel]));
+        }
+        difference.max_difference = std::max(difference.max_difference, pixel_difference);
+        difference.num_different_pixels += pixel_difference > tolerance;
+    }
+    return difference;
+}
+
+/**
+ * CPU reference renderer which reproduces the flat and Phong shading of the viewer without GPU.
+ *
+ * Triangles are set up and binned into screen tiles in parallel (each thread takes a contiguous range of triangles),
+ * and then the tiles are rasterized in parallel. Each tile processes the triangles in the submission order, so the
+ * result does not depend on the number of threads. Edge functions are evaluated in 1/16 subpixel fixed point with the
+ * top-left fill rule, for \p span_width pixels at once (which the compiler vectorizes).
+ *
+ * As with the viewer, counter-clockwise triangles are front faces, back faces are culled, and the depth test is
+ * \p GL_LESS. Triangles are clipped against the near plane, and fragments outside the far plane are discarded.
+ *
+ * @code
+ * SoftwareRasterizer rasterizer { 800, 480 };
+ * rasterizer.clear();
+ * rasterizer.drawPhong(Icosphere<std::uint32_t>::generate(4), mvp_matrix, lighting);
+ * writePpm("phong.ppm", rasterizer.getImage());
+ * @endcode
+ */
+class SoftwareRasterizer{
+public:
+    static constexpr int tile_size = 64;
+    static constexpr int span_width = 8;
+
+    struct Statistics{
+        std::size_t num_triangles = 0; // Number of submitted triangles.
+        std::size_t num_rasterized_triangles = 0; // Number of triangles after culling and clipping.
+        std::size_t num_fragments = 0; // Number of fragments passed the depth test.
+    };
+
+private:
+    struct ClipVertex{
+        glm::vec4 position;
+        std::array<glm::vec3, 2> varyings; // (world position, normal) for Phong shading.
+    };
+
+    struct SetupTriangle{
+        // Edge function w_i(x, y) = a_i * x + b_i * y + c_i, where x and y are in 1/16 subpixel units. c_i includes the
+        // fill rule bias, so the pixel is covered if all w_i >= 0.
+        std::array<std::int64_t, 3> a, b, c;
+        float inv_area;
+        int min_x, min_y, max_x, max_y; // Inclusive pixel bounding box.
+        glm::vec3 depth; // Window space depth of each vertex.
+        glm::vec3 inv_w; // 1 / (clip space w) of each vertex.
+        std::array<std::array<glm::vec3, 2>, 3> varyings_over_w; // For perspective correct interpolation.
+        glm::vec3 flat_color;
+    };
+
+    enum class Interpolation : std::uint8_t {
+        Flat,
+        Perspective,
+    };
+
+    static constexpr std::int64_t subpixel_scale = 16;
+    static constexpr float guard_band = 1 << 24; // Triangles beyond this (in pixels) would overflow the fixed point.
+
+    int width, height;
+    int num_tiles_x, num_tiles_y;
+    unsigned num_threads;
+
+    std::vector<glm::vec3> color_buffer; // Row-major from the bottom row, as OpenGL window coordinates.
+    std::vector<float> depth_buffer;
+
+    // Per-thread storage, kept to reuse the allocations.
+    std::vector<std::vector<SetupTriangle>> thread_triangles;
+    std::vector<std::vector<std::vector<std::uint32_t>>> thread_bins; // [thread][tile] -> indices of thread_triangles[thread].
+
+    std::optional<SetupTriangle> setup(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2, const glm::vec3 &flat_color) const noexcept{
+        const std::array<const ClipVertex*, 3> vertices { &v0, &v1, &v2 };
+
+        SetupTriangle triangle;
+        std::array<std::int64_t, 3> x, y;
+        for (std::size_t i = 0; i < 3; ++i){
+            const glm::vec4 &position = vertices[i]->position;
+            const float inv_w = 1.f / position.w;
+            const float window_x = (position.x * inv_w * 0.5f + 0.5f) * static_cast<float>(width),
+                        window_y = (position.y * inv_w * 0.5f + 0.5f) * static_cast<float>(height);
+            if (!(std::abs(window_x) < guard_band && std::abs(window_y) < guard_band)){
+                return std::nullopt;
+            }
+
+            x[i] = std::llround(window_x * subpixel_scale);
+            y[i] = std::llround(window_y * subpixel_scale);
+            triangle.depth[i] = position.z * inv_w * 0.5f + 0.5f;
+            triangle.inv_w[i] = inv_w;
+            triangle.varyings_over_w[i] = { vertices[i]->varyings[0] * inv_w, vertices[i]->varyings[1] * inv_w };
+        }
+
+        // Back faces (clockwise) and degenerate triangles are culled.
+        const std::int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (area <= 0){
+            return std::nullopt;
+        }
+        triangle.inv_area = 1.f / static_cast<float>(area);
+
+        // Pixel (px, py) is sampled at its center (16 * px + 8, 16 * py + 8).
+        const auto pixel_min = [](std::int64_t v) { return static_cast<int>(std::ceil(static_cast<double>(v - subpixel_scale / 2) / subpixel_scale)); };
+        const auto pixel_max = [](std::int64_t v) { return static_cast<int>(std::floor(static_cast<double>(v - subpixel_scale / 2) / subpixel_scale)); };
+        triangle.min_x = std::max(pixel_min(std::ranges::min(x)), 0);
+        triangle.min_y = std::max(pixel_min(std::ranges::min(y)), 0);
+        triangle.max_x = std::min(pixel_max(std::ranges::max(x)), width - 1);
+        triangle.max_y = std::min(pixel_max(std::ranges::max(y)), height - 1);
+        if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y){
+            return std::nullopt;
+        }
+
+        for (std::size_t i = 0; i < 3; ++i){
+            const std::size_t j = (i + 1) % 3, k = (i + 2) % 3;
+            triangle.a[i] = y[j] - y[k];
+            triangle.b[i] = x[k] - x[j];
+            triangle.c[i] = -(triangle.a[i] * x[j] + triangle.b[i] * y[j]);
+
+            // Top-left fill rule: pixels exactly on the edge are covered only if the edge is a top or left edge.
+            const bool is_top_left = triangle.a[i] > 0 || (triangle.a[i] == 0 && triangle.b[i] < 0);
+            if (!is_top_left){
+                triangle.c[i] -= 1;
+            }
+        }
+
+        triangle.flat_color = flat_color;
+        return triangle;
+    }
+
+    /*
+     * Clip the triangle against the near plane (z >= -w), set up the resulting triangles and append them to the
+     * output. The polygon after clipping has at most 4 vertices.
+     */
+    void clipAndSetup(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2, const glm::vec3 &flat_color,
+                      std::vector<SetupTriangle> &output) const
+    {
+        const std::array<const ClipVertex*, 3> vertices { &v0, &v1, &v2 };
+        const auto distance = [](const ClipVertex &v) { return v.position.z + v.position.w; };
+
+        const auto append = [&](const ClipVertex &a, const ClipVertex &b, const ClipVertex &c){
+            if (auto triangle = setup(a, b, c, flat_color)){
+                output.push_back(*triangle);
+            }
+        };
+
+        if (std::ranges::all_of(vertices, [&](const ClipVertex *v) { return distance(*v) >= 0.f; })){
+            append(v0, v1, v2);
+            return;
+        }
+
+        std::array<ClipVertex, 4> polygon;
+        std::size_t polygon_size = 0;
+        for (std::size_t i = 0; i < 3; ++i){
+            const ClipVertex &current = *vertices[i], &next = *vertices[(i + 1) % 3];
+            const float d_current = distance(current), d_next = distance(next);
+            if (d_current >= 0.f){
+                polygon[polygon_size++] = current;
+            }
+            if ((d_current >= 0.f) != (d_next >= 0.f)){
+                const float t = d_current / (d_current - d_next);
+                polygon[polygon_size++] = ClipVertex {
+                    current.position + t * (next.position - current.position),
+                    { current.varyings[0] + t * (next.varyings[0] - current.varyings[0]),
+                      current.varyings[1] + t * (next.varyings[1] - current.varyings[1]) },
+                };
+            }
+        }
+
+        for (std::size_t i = 2; i < polygon_size; ++i){
+            append(polygon[0], polygon[i - 1], polygon[i]);
+        }
+    }
+
+    void rasterizeTile(int tile_index, Interpolation interpolation, const LightingUniform &lighting, std::size_t &num_fragments){
+        const int tile_x = tile_index % num_tiles_x, tile_y = tile_index / num_tiles_x;
+        const int tile_min_x = tile_x * tile_size, tile_max_x = std::min(tile_min_x + tile_size, width) - 1,
+                  tile_min_y = tile_y * tile_size, tile_max_y = std::min(tile_min_y + tile_size, height) - 1;
+
+        for (std::size_t thread = 0; thread < thread_bins.size(); ++thread){
+            for (std::uint32_t triangle_index : thread_bins[thread][tile_index]){
+                const SetupTriangle &triangle = thread_triangles[thread][triangle_index];
+                const int min_x = std::max(triangle.min_x, tile_min_x), max_x = std::min(triangle.max_x, tile_max_x),
+                          min_y = std::max(triangle.min_y, tile_min_y), max_y = std::min(triangle.max_y, tile_max_y);
+
+                std::array<std::array<std::int64_t, span_width>, 3> lane_offsets;
+                for (std::size_t i = 0; i < 3; ++i){
+                    for (int lane = 0; lane < span_width; ++lane){
+                        lane_offsets[i][lane] = triangle.a[i] * subpixel_scale * lane;
+                    }
+                }
+
+                for (int py = min_y; py <= max_y; ++py){
+                    const std::int64_t sample_y = subpixel_scale * py + subpixel_scale / 2;
+                    for (int span_x = min_x; span_x <= max_x; span_x += span_width){
+                        const std::int64_t sample_x = subpixel_scale * span_x + subpixel_scale / 2;
+
+                        std::array<std::array<std::int64_t, span_width>, 3> w;
+                        for (std::size_t i = 0; i < 3; ++i){
+                            const std::int64_t w_span = triangle.a[i] * sample_x + triangle.b[i] * sample_y + triangle.c[i];
+                            for (int lane = 0; lane < span_width; ++lane){
+                                w[i][lane] = w_span + lane_offsets[i][lane];
+                            }
+                        }
+
+                        std::array<bool, span_width> covered;
+                        bool any_covered = false;
+                        for (int lane = 0; lane < span_width; ++lane){
+                            covered[lane] = (w[0][lane] | w[1][lane] | w[2][lane]) >= 0 && span_x + lane <= max_x;
+                            any_covered |= covered[lane];
+                        }
+                        if (!any_covered){
+                            continue;
+                        }
+
+                        for (int lane = 0; lane < span_width; ++lane){
+                            if (!covered[lane]){
+                                continue;
+                            }
+
+                            const glm::vec3 barycentric = triangle.inv_area * glm::vec3 {
+                                static_cast<float>(w[0][lane]), static_cast<float>(w[1][lane]), static_cast<float>(w[2][lane])
+                            };
+                            const float depth = glm::dot(barycentric, triangle.depth);
+                            const std::size_t pixel_index = static_cast<std::size_t>(py) * width + (span_x + lane);
+                            if (depth < 0.f || depth > 1.f || depth >= depth_buffer[pixel_index]){
+                                continue;
+                            }
+
+                            glm::vec3 color;
+                            if (interpolation == Interpolation::Flat){
+                                color = triangle.flat_color;
+                            }
+                            else{
+                                const glm::vec3 weights = barycentric / glm::dot(barycentric, triangle.inv_w);
+                                const glm::vec3 frag_pos = weights.x * triangle.varyings_over_w[0][0]
+                                                         + weights.y * triangle.varyings_over_w[1][0]
+                                                         + weights.z * triangle.varyings_over_w[2][0];
+                                const glm::vec3 normal = weights.x * triangle.varyings_over_w[0][1]
+                                                       + weights.y * triangle.varyings_over_w[1][1]
+                                                       + weights.z * triangle.varyings_over_w[2][1];
+                                color = LightingModel::shade(frag_pos, glm::normalize(normal), lighting);
+                            }
+
+                            depth_buffer[pixel_index] = depth;
+                            color_buffer[pixel_index] = color;
+                            ++num_fragments;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename TriangleFn>
+    Statistics drawTriangles(std::size_t num_triangles, TriangleFn &&triangle_vertices, Interpolation interpolation, const LightingUniform &lighting){
+        Statistics statistics { .num_triangles = num_triangles };
+        const std::size_t num_tiles = static_cast<std::size_t>(num_tiles_x) * num_tiles_y;
+
+        // Set up and bin the triangles.
+        parallel_for(0U, num_threads, [&](unsigned first_thread, unsigned last_thread){
+            for (unsigned thread = first_thread; thread < last_thread; ++thread){
+                std::vector<SetupTriangle> &triangles = thread_triangles[thread];
+                std::vector<std::vector<std::uint32_t>> &bins = thread_bins[thread];
+                triangles.clear();
+                for (auto &bin : bins){
+                    bin.clear();
+                }
+
+                const std::size_t first = num_triangles * thread / num_threads,
+                                  last = num_triangles * (thread + 1) / num_threads;
+                for (std::size_t triangle_index = first; triangle_index < last; ++triangle_index){
+                    const auto [v0, v1, v2, flat_color] = triangle_vertices(triangle_index);
+
+                    const std::size_t first_setup = triangles.size();
+                    clipAndSetup(v0, v1, v2, flat_color, triangles);
+                    for (std::size_t setup_index = first_setup; setup_index < triangles.size(); ++setup_index){
+                        const SetupTriangle &triangle = triangles[setup_index];
+                        for (int tile_y = triangle.min_y / tile_size; tile_y <= triangle.max_y / tile_size; ++tile_y){
+                            for (int tile_x = triangle.min_x / tile_size; tile_x <= triangle.max_x / tile_size; ++tile_x){
+                                bins[tile_y * num_tiles_x + tile_x].push_back(static_cast<std::uint32_t>(setup_index));
+                            }
+                        }
+                    }
+                }
+            }
+        }, num_threads);
+
+        for (const auto &triangles : thread_triangles){
+            statistics.num_rasterized_triangles += triangles.size();
+        }
+
+        // Rasterize the tiles. Tiles are dynamically assigned since their loads are uneven.
+        std::atomic<std::size_t> next_tile = 0, num_fragments = 0;
+        parallel_for(0U, num_threads, [&](unsigned first_thread, unsigned last_thread){
+            for (unsigned thread = first_thread; thread < last_thread; ++thread){
+                std::size_t thread_num_fragments = 0;
+                for (std::size_t tile = next_tile++; tile < num_tiles; tile = next_tile++){
+                    rasterizeTile(static_cast<int>(tile), interpolation, lighting, thread_num_fragments);
+                }
+                num_fragments += thread_num_fragments;
+            }
+        }, num_threads);
+        statistics.num_fragments = num_fragments;
+
+        return statistics;
+    }
+
+    static ClipVertex transform(const glm::vec3 &position, const glm::vec3 &normal, const MvpMatrixUniform &mvp_matrix) noexcept{
+        const glm::vec4 frag_pos = mvp_matrix.model * glm::vec4 { position, 1.f };
+        return {
+            mvp_matrix.projection_view * frag_pos,
+            { glm::vec3 { frag_pos }, glm::mat3 { glm::transpose(mvp_matrix.inv_model) } * normal },
+        };
+    }
+
+public:
+    SoftwareRasterizer(int width, int height, unsigned num_threads = default_thread_count())
+            : width { width }, height { height },
+              num_tiles_x { (width + tile_size - 1) / tile_size }, num_tiles_y { (height + tile_size - 1) / tile_size },
+              num_threads { std::max(num_threads, 1U) },
+              color_buffer(static_cast<std::size_t>(width) * height),
+              depth_buffer(static_cast<std::size_t>(width) * height),
+              thread_triangles(this->num_threads),
+              thread_bins(this->num_threads, std::vector<std::vector<std::uint32_t>>(static_cast<std::size_t>(num_tiles_x) * num_tiles_y))
+    {
+        if (width <= 0 || height <= 0){
+            throw std::invalid_argument { "Framebuffer size must be positive." };
+        }
+    }
+
+    [[nodiscard]] int getWidth() const noexcept{
+        return width;
+    }
+
+    [[nodiscard]] int getHeight() const noexcept{
+        return height;
+    }
+
+    void clear(const glm::vec3 &color = glm::vec3 { 0.f }){
+        std::ranges::fill(color_buffer, color);
+        std::ranges::fill(depth_buffer, 1.f);
+    }
+
+    /**
+     * Draw non-indexed triangles with per-face color, as \p flat.vert and \p flat.frag do. The color of each triangle is
+     * evaluated at its last vertex (OpenGL's default provoking vertex).
+     * @param vertices Vertices of the triangles, whose size must be a multiple of 3.
+     */
+    Statistics drawFlat(std::span<const Vertex> vertices, const MvpMatrixUniform &mvp_matrix, const LightingUniform &lighting){
+        std::vector<ClipVertex> clip_vertices(vertices.size());
+        std::vector<glm::vec3> colors(vertices.size());
+        parallel_for(std::size_t { 0 }, vertices.size(), [&](std::size_t first, std::size_t last){
+            for (std::size_t i = first; i < last; ++i){
+                clip_vertices[i] = transform(vertices[i].position, vertices[i].normal, mvp_matrix);
+                colors[i] = LightingModel::shade(clip_vertices[i].varyings[0], glm::normalize(clip_vertices[i].varyings[1]), lighting);
+            }
+        }, num_threads);
+
+        return drawTriangles(vertices.size() / 3, [&](std::size_t triangle_index){
+            return std::tuple<const ClipVertex&, const ClipVertex&, const ClipVertex&, const glm::vec3&> {
+                clip_vertices[3 * triangle_index],
+                clip_vertices[3 * triangle_index + 1],
+                clip_vertices[3 * triangle_index + 2],
+                colors[3 * triangle_index + 2],
+            };
+        }, Interpolation::Flat, lighting);
+    }
+
+    /**
+     * Draw the mesh with per-fragment lighting, as \p phong.vert and \p phong.frag do. As in the viewer, the position
+     * of each vertex is also used as its normal.
+     */
+    template <typename IndexType>
+    Statistics drawPhong(const Mesh<IndexType> &mesh, const MvpMatrixUniform &mvp_matrix, const LightingUniform &lighting){
+        std::vector<ClipVertex> clip_vertices(mesh.positions.size());
+        parallel_for(std::size_t { 0 }, mesh.positions.size(), [&](std::size_t first, std::size_t last){
+            for (std::size_t i = first; i < last; ++i){
+                clip_vertices[i] = transform(mesh.positions[i], mesh.positions[i], mvp_matrix);
+            }
+        }, num_threads);
+
+        constexpr glm::vec3 unused_flat_color { 0.f };
+        return drawTriangles(mesh.triangle_indices.size(), [&](std::size_t triangle_index){
+            const auto [i1, i2, i3] = mesh.triangle_indices[triangle_index];
+            return std::tuple<const ClipVertex&, const ClipVertex&, const ClipVertex&, const glm::vec3&> {
+                clip_vertices[i1], clip_vertices[i2], clip_vertices[i3], unused_flat_color,
+            };
+        }, Interpolation::Perspective, lighting);
+    }
+
+    /**
+     * @brief Get the rendered image, with colors clamped to [0, 1] and quantized to 8 bits as the default framebuffer.
+     */
+    [[nodiscard]] Image getImage() const{
+        Image image { width, height, std::vector<std::array<std::uint8_t, 3>>(color_buffer.size()) };
+        for (int y = 0; y < height; ++y){
+            for (int x = 0; x < width; ++x){
+                const glm::vec3 color = glm::clamp(color_buffer[static_cast<std::size_t>(y) * width + x], 0.f, 1.f);
+                image.pixels[static_cast<std::size_t>(height - 1 - y) * width + x] = {
+                    static_cast<std::uint8_t>(std::lround(color.x * 255.f)),
+                    static_cast<std::uint8_t>(std::lround(color.y * 255.f)),
+                    static_cast<std::uint8_t>(std::lround(color.z * 255.f)),
+                };
+            }
+        }
+        return image;
+    }
+};
@@ -0,0 +1,19 @@
+//
+// Created by gomkyung2 on 2026/10/18.
+//
+
+#pragma once
+
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+
+struct MvpMatrixUniform{
+    glm::mat4 model;
+    glm::mat4 inv_model;
+    glm::mat4 projection_view;
+};
+
+struct LightingUniform{
+    alignas(16) glm::vec3 view_pos;  // std140: base alignment must be 16 for vec3.
+    alignas(16) glm::vec3 light_pos; // std140: base alignment must be 16 for vec3.
+};
\ No newline at end of file